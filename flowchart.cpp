@@ -25,6 +25,14 @@
  *It stores the sip-messages and draw it directly into mainwindow.ui.
  *This is possible because when instantiating this object from mainwindow.cpp
  *the ui has to be handed over to this class for referencing to the ui.
+ *The ladder-diagram is virtualized: the scene holds no items, only the rows
+ *visible in the viewport are painted out of m_messages (drawForeground) and
+ *the lifelines are painted in drawBackground. So appending and scrolling
+ *cost the same, no matter how many messages are stored.
+ *The messages are kept in a SipHistory (see siphistory.h/cpp), which spills
+ *older messages to disk and pages them back in for painting.
+ *A SipIndex (see sipindex.h/cpp) allows to show only one dialog, selected
+ *by Call-ID or by a double-click on one of its messages.
  *
  *
  * License:
@@ -45,10 +53,14 @@
 #include "flowchart.h"
 
 #include <QObject>
-#include <QGraphicsTextItem>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
 
 const int left_x = 50;
 const int right_x = 350;
+const int row_height = 40;
+const int header_height = 40;
 
 FlowChart::FlowChart(QWidget* parent)
     : QGraphicsView(parent), m_scene(new QGraphicsScene(this)) {
@@ -58,60 +70,130 @@ FlowChart::FlowChart(QWidget* parent)
 
     setDragMode(QGraphicsView::ScrollHandDrag);
     setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    FlowChart::update_scene_rect();
 }
 
-SipEvent FlowChart::parse_message(const QString& log_message) {
+void FlowChart::add_message(const SipMessageInfo& info, const QByteArray& message) {
+    //The buffer out of the log-ring is shared, not copied - the classification is already done
     SipEvent event;
+    event.raw = message;
+    event.info = info;
+
+    bool follow = verticalScrollBar()->value() == verticalScrollBar()->maximum();
+    m_index.add(m_history.size(), event);
+    m_history.append(event);
+    if (!m_filter_call_id.isEmpty() && event.view(info.call_id) != m_filter_call_id) {
+        return;
+    }
+    FlowChart::update_scene_rect();
 
-    if (log_message.contains("Request msg")) {
-        event.is_request = true;
-        auto parts = log_message.split("Request msg ");
-        event.message_header = parts[1].split(" ")[0];
-    } else if (log_message.contains("Response msg")) {
-        event.is_request = false;
-        auto parts = log_message.split("Response msg ");
-        event.message_header = parts[1].split(" ")[0];
+    //Only the new row has to be painted, nothing is added to the scene
+    int row = FlowChart::visible_count() - 1;
+    invalidateScene(QRectF(0, row * row_height, sceneRect().width(), row_height));
+    if (row == 0) {
+        invalidateScene(QRectF(0, -header_height, sceneRect().width(), header_height));
+    }
+    if (follow) {
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
     }
+}
 
-    if (log_message.contains("to TCP")) {
-        event.destination_ip = log_message.section("to TCP ", 1).section(":", 0, 0);
-        event.source_ip = log_message.section("SIP/2.0/TCP ", 1).section(":", 0, 0);
+int FlowChart::set_dialog_filter(const QByteArray& call_id) {
+    m_filter_call_id = call_id;
+    FlowChart::update_scene_rect();
+    invalidateScene();
+    verticalScrollBar()->setValue(verticalScrollBar()->minimum());
+    return FlowChart::visible_count();
+}
+
+int FlowChart::visible_count() const {
+    if (m_filter_call_id.isEmpty()) {
+        return m_history.size();
     }
-    if (log_message.contains("from TCP")) {
-        event.source_ip = log_message.section("from TCP ", 1).section(":", 0, 0);
-        event.destination_ip = log_message.section("SIP/2.0/TCP ", 1).section(":", 0, 0);
+    return int(m_index.rows_for_call_id(m_filter_call_id).size());
+}
+
+int FlowChart::history_row(int visible_row) const {
+    if (m_filter_call_id.isEmpty()) {
+        return visible_row;
     }
+    return m_index.rows_for_call_id(m_filter_call_id)[size_t(visible_row)];
+}
 
-    int pos = log_message.indexOf(":\n");
-    if (pos != -1) {
-        event.sip_message = log_message.mid(pos + 2);
+void FlowChart::update_scene_rect() {
+    m_scene->setSceneRect(0, -header_height, right_x + 100, header_height + qMax(1, FlowChart::visible_count()) * row_height);
+}
+
+void FlowChart::mouseDoubleClickEvent(QMouseEvent* event) {
+    //Double-click on a message shows only its dialog, the next double-click shows all again
+    if (!m_filter_call_id.isEmpty()) {
+        FlowChart::set_dialog_filter(QByteArray());
+        return;
     }
 
-    return event;
+    qreal y = mapToScene(event->pos()).y();
+    int row = int(y / row_height);
+    if (y < 0 || row >= FlowChart::visible_count()) {
+        return;
+    }
+    SipEvent message = m_history.at(FlowChart::history_row(row));
+    if (!message.info.call_id.is_empty()) {
+        QByteArray call_id = message.view(message.info.call_id);
+        FlowChart::set_dialog_filter(QByteArray(call_id.constData(), call_id.size()));
+    }
 }
 
-void FlowChart::add_message(const QString& log_message) {
-    SipEvent message = FlowChart::parse_message(log_message);
-    m_messages.push_back(message);
-    FlowChart::draw_event(message);
+void FlowChart::drawBackground(QPainter* painter, const QRectF& rect) {
+    QGraphicsView::drawBackground(painter, rect);
+
+    //Lifelines, only the visible part
+    qreal top = qMax<qreal>(rect.top(), 0);
+    qreal bottom = qMin<qreal>(rect.bottom(), qreal(FlowChart::visible_count()) * row_height);
+    if (bottom <= top) {
+        return;
+    }
+    painter->setPen(QPen(Qt::black));
+    painter->drawLine(QPointF(left_x, top), QPointF(left_x, bottom));
+    painter->drawLine(QPointF(right_x, top), QPointF(right_x, bottom));
 }
 
-void FlowChart::draw_event(const SipEvent& message) {
-    int y = m_current_y + 20;
-    m_current_y += 40;
+void FlowChart::drawForeground(QPainter* painter, const QRectF& rect) {
+    int count = FlowChart::visible_count();
+    if (count == 0) {
+        return;
+    }
+
+    if (rect.top() < 0) {
+        SipEvent first = m_history.at(FlowChart::history_row(0));
+        painter->setPen(QPen(Qt::black));
+        painter->drawText(QRectF(left_x - 30, -20, 200, 20), Qt::AlignLeft | Qt::AlignVCenter, first.source_ip());
+        painter->drawText(QRectF(right_x - 30, -20, 200, 20), Qt::AlignLeft | Qt::AlignVCenter, first.destination_ip());
+    }
 
-    m_scene->addLine(left_x, 0, left_x, m_current_y, QPen(Qt::black));
-    m_scene->addLine(right_x, 0, right_x, m_current_y, QPen(Qt::black));
+    //Only the rows intersecting the exposed rect are painted
+    int first_row = qMax(0, int(rect.top() / row_height));
+    int last_row = qMin(count - 1, int(rect.bottom() / row_height));
+    for (int row = first_row; row <= last_row; ++row) {
+        FlowChart::draw_event(painter, m_history.at(FlowChart::history_row(row)), row);
+    }
+}
 
-    if (m_messages.size() == 1) {
-        m_scene->addText(message.source_ip)->setPos(left_x - 30, -20);
-        m_scene->addText(message.destination_ip)->setPos(right_x -30, -20);
+void FlowChart::draw_event(QPainter* painter, const SipEvent& message, int row) {
+    int y = row * row_height + 20;
+
+    //The segment of this row was already removed from the disk
+    if (message.raw.isEmpty()) {
+        painter->setPen(QPen(Qt::gray));
+        painter->drawText(QRectF(left_x, y - 10, right_x - left_x, 20), Qt::AlignCenter, "(dropped out of the SIP-history)");
+        return;
     }
 
-    int src_x = message.is_request ? left_x : right_x;
-    int dst_x = message.is_request ? right_x : left_x;
+    int src_x = message.is_request() ? left_x : right_x;
+    int dst_x = message.is_request() ? right_x : left_x;
+
+    painter->setPen(QPen(Qt::blue, 2));
+    painter->drawLine(src_x, y, dst_x, y);
 
-    QGraphicsLineItem* arrow = m_scene->addLine(src_x, y, dst_x, y, QPen(Qt::blue, 2));
     QPolygonF arrow_head;
     if (src_x < dst_x) {
         arrow_head << QPointF(dst_x, y)
@@ -123,8 +205,11 @@ void FlowChart::draw_event(const SipEvent& message) {
                    << QPointF(dst_x + 10, y + 5);
     }
 
-    m_scene->addPolygon(arrow_head, QPen(Qt::blue), QBrush(Qt::blue));
+    painter->setPen(QPen(Qt::blue));
+    painter->setBrush(QBrush(Qt::blue));
+    painter->drawPolygon(arrow_head);
+    painter->setBrush(Qt::NoBrush);
 
-    QGraphicsTextItem* label = m_scene->addText(message.message_header);
-    label->setPos((src_x + dst_x) / 2 - 60, y - 20);
+    painter->setPen(QPen(Qt::black));
+    painter->drawText(QRectF((src_x + dst_x) / 2 - 60, y - 20, 200, 18), Qt::AlignLeft | Qt::AlignVCenter, message.message_header());
 }
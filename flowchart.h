@@ -25,6 +25,14 @@
  *It stores the sip-messages and draw it directly into mainwindow.ui.
  *This is possible because when instantiating this object from mainwindow.cpp
  *the ui has to be handed over to this class for referencing to the ui.
+ *The ladder-diagram is virtualized: the scene holds no items, only the rows
+ *visible in the viewport are painted out of m_messages (drawForeground) and
+ *the lifelines are painted in drawBackground. So appending and scrolling
+ *cost the same, no matter how many messages are stored.
+ *The messages are kept in a SipHistory (see siphistory.h/cpp), which spills
+ *older messages to disk and pages them back in for painting.
+ *A SipIndex (see sipindex.h/cpp) allows to show only one dialog, selected
+ *by Call-ID or by a double-click on one of its messages.
  *
  *
  * License:
@@ -47,30 +55,41 @@
 
 #include <QString>
 #include <QGraphicsView>
+#include <QByteArray>
 
-struct SipEvent {
-    QString source_ip;
-    QString destination_ip;
-    QString message_header;
-    QString sip_message;
-    bool is_request;
-};
+#include "sipevent.h"
+#include "siphistory.h"
+#include "sipindex.h"
 
 class FlowChart : public QGraphicsView {
     Q_OBJECT
 public:
     FlowChart(QWidget* parent = nullptr);
 
+    const SipIndex& index() const { return m_index; }
+    //Empty Call-ID shows all messages again, returns the number of shown messages
+    int set_dialog_filter(const QByteArray& call_id);
+
 public slots:
-    void add_message(const QString& log_message);
+    void add_message(const SipMessageInfo& info, const QByteArray& message);
+
+protected:
+    void drawBackground(QPainter* painter, const QRectF& rect) override;
+    void drawForeground(QPainter* painter, const QRectF& rect) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
 
 private:
     QGraphicsScene* m_scene;
-    QVector<SipEvent> m_messages;
-    int m_current_y = 0;
+    SipHistory m_history;
+    SipIndex m_index;
+    QByteArray m_filter_call_id;
+
+    //Rows of the view are mapped to rows of the history while a filter is active
+    int visible_count() const;
+    int history_row(int visible_row) const;
 
-    SipEvent parse_message(const QString& log_message);
-    void draw_event(const SipEvent& event);
+    void draw_event(QPainter* painter, const SipEvent& event, int row);
+    void update_scene_rect();
 };
 
 #endif // FLOWCHART_H
@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file g711.h/cpp:
+ *The G711-Class contains the ITU-T G.711 A-law (PCMA) and u-law (PCMU)
+ *converters between 16 bit linear PCM and the 8 bit companded samples.
+ *The single-sample functions follow the well known Sun reference
+ *implementation bit-exactly, the block functions convert a complete frame.
+ *The block functions use SSE4.1 or AVX2 if the CPU supports it (selected
+ *once at runtime, with GCC/Clang and MSVC) and are bit-exact to the
+ *single-sample functions.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "g711.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define G711_X86_SIMD
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define G711_X86_SIMD
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+//GCC/Clang only emit the instructions of a function with a target-attribute, MSVC emits every
+//intrinsic without /arch, the runtime-dispatch decides which function is called
+#if defined(__GNUC__) || defined(__clang__)
+#define G711_TARGET(isa) __attribute__((target(isa)))
+#else
+#define G711_TARGET(isa)
+#endif
+
+//Segment end-points (A-law on 13 bit, u-law on 14 bit magnitude)
+static const int16_t seg_aend[8] = {0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF};
+static const int16_t seg_uend[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+
+//u-law bias (on 14 bit) and clip-level
+static const int16_t ulaw_bias = 0x21;
+static const int16_t ulaw_clip = 8159;
+
+static inline int segment(int value, const int16_t* table) {
+    for (int i = 0; i < 8; i++) {
+        if (value <= table[i]) {
+            return i;
+        }
+    }
+    return 8;
+}
+
+uint8_t G711::linear_to_alaw(int16_t pcm) {
+    int value = pcm >> 3;
+    int mask;
+    if (value >= 0) {
+        mask = 0xD5;
+    } else {
+        mask = 0x55;
+        value = -value - 1;
+    }
+
+    int seg = segment(value, seg_aend);
+    if (seg >= 8) {
+        return uint8_t(0x7F ^ mask);
+    }
+
+    int aval = seg << 4;
+    if (seg < 2) {
+        aval |= (value >> 1) & 0x0F;
+    } else {
+        aval |= (value >> seg) & 0x0F;
+    }
+    return uint8_t(aval ^ mask);
+}
+
+uint8_t G711::linear_to_ulaw(int16_t pcm) {
+    int value = pcm >> 2;
+    int mask;
+    if (value < 0) {
+        value = -value;
+        mask = 0x7F;
+    } else {
+        mask = 0xFF;
+    }
+    if (value > ulaw_clip) {
+        value = ulaw_clip;
+    }
+    value += ulaw_bias;
+
+    int seg = segment(value, seg_uend);
+    if (seg >= 8) {
+        return uint8_t(0x7F ^ mask);
+    }
+
+    int uval = (seg << 4) | ((value >> (seg + 1)) & 0x0F);
+    return uint8_t(uval ^ mask);
+}
+
+int16_t G711::alaw_to_linear(uint8_t alaw) {
+    int value = alaw ^ 0x55;
+    int t = (value & 0x0F) << 4;
+    int seg = (value & 0x70) >> 4;
+    switch (seg) {
+    case 0:
+        t += 8;
+        break;
+    case 1:
+        t += 0x108;
+        break;
+    default:
+        t += 0x108;
+        t <<= seg - 1;
+        break;
+    }
+    return int16_t((value & 0x80) ? t : -t);
+}
+
+int16_t G711::ulaw_to_linear(uint8_t ulaw) {
+    int value = ~ulaw & 0xFF;
+    int t = ((value & 0x0F) << 3) + 0x84;
+    t <<= (value & 0x70) >> 4;
+    return int16_t((value & 0x80) ? (0x84 - t) : (t - 0x84));
+}
+
+//Block converters: scalar reference plus SSE4.1/AVX2 versions, selected once at runtime.
+//The vector versions are bit-exact to the single-sample functions above: the segment is
+//counted with compares against the end-points and the variable shift is done with a
+//multiplication by a power of two looked up per lane with pshufb.
+
+static void scalar_encode_alaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = G711::linear_to_alaw(pcm[i]);
+    }
+}
+
+static void scalar_encode_ulaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = G711::linear_to_ulaw(pcm[i]);
+    }
+}
+
+static void scalar_decode_alaw(const uint8_t* alaw, size_t samples, int16_t* out) {
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = G711::alaw_to_linear(alaw[i]);
+    }
+}
+
+static void scalar_decode_ulaw(const uint8_t* ulaw, size_t samples, int16_t* out) {
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = G711::ulaw_to_linear(ulaw[i]);
+    }
+}
+
+#ifdef G711_X86_SIMD
+
+//High byte of the multiplier 2^(16 - shift) for mulhi, indexed by segment
+#define ALAW_ENCODE_SHIFT 0x80, 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0, 0, 0, 0, 0, 0, 0, 0
+#define ULAW_ENCODE_SHIFT 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, 0, 0, 0, 0, 0, 0, 0, 0
+//Multiplier 2^shift for mullo, indexed by segment
+#define ALAW_DECODE_SHIFT 1, 1, 2, 4, 8, 16, 32, 64, 0, 0, 0, 0, 0, 0, 0, 0
+#define ULAW_DECODE_SHIFT 1, 2, 4, 8, 16, 32, 64, 128, 0, 0, 0, 0, 0, 0, 0, 0
+
+G711_TARGET("sse4.1")
+static inline __m128i sse_alaw(__m128i pcm) {
+    __m128i value = _mm_srai_epi16(pcm, 3);
+    __m128i sign = _mm_srai_epi16(value, 15);
+    __m128i magnitude = _mm_xor_si128(value, sign);
+    __m128i seg = _mm_setzero_si128();
+    for (int i = 0; i < 7; i++) {
+        seg = _mm_sub_epi16(seg, _mm_cmpgt_epi16(magnitude, _mm_set1_epi16(seg_aend[i])));
+    }
+    __m128i multiplier = _mm_slli_epi16(_mm_shuffle_epi8(_mm_setr_epi8(ALAW_ENCODE_SHIFT), seg), 8);
+    __m128i mantissa = _mm_and_si128(_mm_mulhi_epu16(magnitude, multiplier), _mm_set1_epi16(0x0F));
+    __m128i aval = _mm_or_si128(_mm_slli_epi16(seg, 4), mantissa);
+    __m128i mask = _mm_xor_si128(_mm_set1_epi16(0xD5), _mm_and_si128(sign, _mm_set1_epi16(0x80)));
+    return _mm_xor_si128(aval, mask);
+}
+
+G711_TARGET("sse4.1")
+static inline __m128i sse_ulaw(__m128i pcm) {
+    __m128i value = _mm_srai_epi16(pcm, 2);
+    __m128i sign = _mm_srai_epi16(value, 15);
+    __m128i magnitude = _mm_min_epi16(_mm_abs_epi16(value), _mm_set1_epi16(ulaw_clip));
+    //Clip+bias can only reach 0x2000, which encodes the same as 0x1FFF
+    magnitude = _mm_min_epi16(_mm_add_epi16(magnitude, _mm_set1_epi16(ulaw_bias)), _mm_set1_epi16(0x1FFF));
+    __m128i seg = _mm_setzero_si128();
+    for (int i = 0; i < 7; i++) {
+        seg = _mm_sub_epi16(seg, _mm_cmpgt_epi16(magnitude, _mm_set1_epi16(seg_uend[i])));
+    }
+    __m128i multiplier = _mm_slli_epi16(_mm_shuffle_epi8(_mm_setr_epi8(ULAW_ENCODE_SHIFT), seg), 8);
+    __m128i mantissa = _mm_and_si128(_mm_mulhi_epu16(magnitude, multiplier), _mm_set1_epi16(0x0F));
+    __m128i uval = _mm_or_si128(_mm_slli_epi16(seg, 4), mantissa);
+    __m128i mask = _mm_xor_si128(_mm_set1_epi16(0xFF), _mm_and_si128(sign, _mm_set1_epi16(0x80)));
+    return _mm_xor_si128(uval, mask);
+}
+
+G711_TARGET("sse4.1")
+static inline __m128i sse_alaw_to_linear(__m128i alaw) {
+    __m128i value = _mm_xor_si128(alaw, _mm_set1_epi16(0x55));
+    __m128i seg = _mm_srli_epi16(_mm_and_si128(value, _mm_set1_epi16(0x70)), 4);
+    __m128i t = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(0x0F)), 4);
+    t = _mm_add_epi16(t, _mm_set1_epi16(8));
+    t = _mm_add_epi16(t, _mm_and_si128(_mm_cmpgt_epi16(seg, _mm_setzero_si128()), _mm_set1_epi16(0x100)));
+    __m128i multiplier = _mm_and_si128(_mm_shuffle_epi8(_mm_setr_epi8(ALAW_DECODE_SHIFT), seg), _mm_set1_epi16(0xFF));
+    t = _mm_mullo_epi16(t, multiplier);
+    __m128i negative = _mm_cmpeq_epi16(_mm_and_si128(value, _mm_set1_epi16(0x80)), _mm_setzero_si128());
+    return _mm_sub_epi16(_mm_xor_si128(t, negative), negative);
+}
+
+G711_TARGET("sse4.1")
+static inline __m128i sse_ulaw_to_linear(__m128i ulaw) {
+    __m128i value = _mm_xor_si128(ulaw, _mm_set1_epi16(0xFF));
+    __m128i seg = _mm_srli_epi16(_mm_and_si128(value, _mm_set1_epi16(0x70)), 4);
+    __m128i t = _mm_add_epi16(_mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(0x0F)), 3), _mm_set1_epi16(0x84));
+    __m128i multiplier = _mm_and_si128(_mm_shuffle_epi8(_mm_setr_epi8(ULAW_DECODE_SHIFT), seg), _mm_set1_epi16(0xFF));
+    t = _mm_sub_epi16(_mm_mullo_epi16(t, multiplier), _mm_set1_epi16(0x84));
+    __m128i negative = _mm_cmpeq_epi16(_mm_and_si128(value, _mm_set1_epi16(0x80)), _mm_set1_epi16(0x80));
+    return _mm_sub_epi16(_mm_xor_si128(t, negative), negative);
+}
+
+G711_TARGET("sse4.1")
+static void sse_encode_alaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        __m128i low = sse_alaw(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pcm + i)));
+        __m128i high = sse_alaw(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pcm + i + 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(low, high));
+    }
+    scalar_encode_alaw(pcm + i, samples - i, out + i);
+}
+
+G711_TARGET("sse4.1")
+static void sse_encode_ulaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        __m128i low = sse_ulaw(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pcm + i)));
+        __m128i high = sse_ulaw(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pcm + i + 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(low, high));
+    }
+    scalar_encode_ulaw(pcm + i, samples - i, out + i);
+}
+
+G711_TARGET("sse4.1")
+static void sse_decode_alaw(const uint8_t* alaw, size_t samples, int16_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        __m128i value = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(alaw + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), sse_alaw_to_linear(value));
+    }
+    scalar_decode_alaw(alaw + i, samples - i, out + i);
+}
+
+G711_TARGET("sse4.1")
+static void sse_decode_ulaw(const uint8_t* ulaw, size_t samples, int16_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        __m128i value = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ulaw + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), sse_ulaw_to_linear(value));
+    }
+    scalar_decode_ulaw(ulaw + i, samples - i, out + i);
+}
+
+//The AVX2 versions are the same, pshufb works per 128 bit lane, so the tables are doubled
+
+G711_TARGET("avx2")
+static inline __m256i avx2_alaw(__m256i pcm) {
+    __m256i value = _mm256_srai_epi16(pcm, 3);
+    __m256i sign = _mm256_srai_epi16(value, 15);
+    __m256i magnitude = _mm256_xor_si256(value, sign);
+    __m256i seg = _mm256_setzero_si256();
+    for (int i = 0; i < 7; i++) {
+        seg = _mm256_sub_epi16(seg, _mm256_cmpgt_epi16(magnitude, _mm256_set1_epi16(seg_aend[i])));
+    }
+    __m256i multiplier = _mm256_slli_epi16(_mm256_shuffle_epi8(_mm256_setr_epi8(ALAW_ENCODE_SHIFT, ALAW_ENCODE_SHIFT), seg), 8);
+    __m256i mantissa = _mm256_and_si256(_mm256_mulhi_epu16(magnitude, multiplier), _mm256_set1_epi16(0x0F));
+    __m256i aval = _mm256_or_si256(_mm256_slli_epi16(seg, 4), mantissa);
+    __m256i mask = _mm256_xor_si256(_mm256_set1_epi16(0xD5), _mm256_and_si256(sign, _mm256_set1_epi16(0x80)));
+    return _mm256_xor_si256(aval, mask);
+}
+
+G711_TARGET("avx2")
+static inline __m256i avx2_ulaw(__m256i pcm) {
+    __m256i value = _mm256_srai_epi16(pcm, 2);
+    __m256i sign = _mm256_srai_epi16(value, 15);
+    __m256i magnitude = _mm256_min_epi16(_mm256_abs_epi16(value), _mm256_set1_epi16(ulaw_clip));
+    magnitude = _mm256_min_epi16(_mm256_add_epi16(magnitude, _mm256_set1_epi16(ulaw_bias)), _mm256_set1_epi16(0x1FFF));
+    __m256i seg = _mm256_setzero_si256();
+    for (int i = 0; i < 7; i++) {
+        seg = _mm256_sub_epi16(seg, _mm256_cmpgt_epi16(magnitude, _mm256_set1_epi16(seg_uend[i])));
+    }
+    __m256i multiplier = _mm256_slli_epi16(_mm256_shuffle_epi8(_mm256_setr_epi8(ULAW_ENCODE_SHIFT, ULAW_ENCODE_SHIFT), seg), 8);
+    __m256i mantissa = _mm256_and_si256(_mm256_mulhi_epu16(magnitude, multiplier), _mm256_set1_epi16(0x0F));
+    __m256i uval = _mm256_or_si256(_mm256_slli_epi16(seg, 4), mantissa);
+    __m256i mask = _mm256_xor_si256(_mm256_set1_epi16(0xFF), _mm256_and_si256(sign, _mm256_set1_epi16(0x80)));
+    return _mm256_xor_si256(uval, mask);
+}
+
+G711_TARGET("avx2")
+static inline __m256i avx2_alaw_to_linear(__m256i alaw) {
+    __m256i value = _mm256_xor_si256(alaw, _mm256_set1_epi16(0x55));
+    __m256i seg = _mm256_srli_epi16(_mm256_and_si256(value, _mm256_set1_epi16(0x70)), 4);
+    __m256i t = _mm256_slli_epi16(_mm256_and_si256(value, _mm256_set1_epi16(0x0F)), 4);
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(8));
+    t = _mm256_add_epi16(t, _mm256_and_si256(_mm256_cmpgt_epi16(seg, _mm256_setzero_si256()), _mm256_set1_epi16(0x100)));
+    __m256i multiplier = _mm256_and_si256(_mm256_shuffle_epi8(_mm256_setr_epi8(ALAW_DECODE_SHIFT, ALAW_DECODE_SHIFT), seg), _mm256_set1_epi16(0xFF));
+    t = _mm256_mullo_epi16(t, multiplier);
+    __m256i negative = _mm256_cmpeq_epi16(_mm256_and_si256(value, _mm256_set1_epi16(0x80)), _mm256_setzero_si256());
+    return _mm256_sub_epi16(_mm256_xor_si256(t, negative), negative);
+}
+
+G711_TARGET("avx2")
+static inline __m256i avx2_ulaw_to_linear(__m256i ulaw) {
+    __m256i value = _mm256_xor_si256(ulaw, _mm256_set1_epi16(0xFF));
+    __m256i seg = _mm256_srli_epi16(_mm256_and_si256(value, _mm256_set1_epi16(0x70)), 4);
+    __m256i t = _mm256_add_epi16(_mm256_slli_epi16(_mm256_and_si256(value, _mm256_set1_epi16(0x0F)), 3), _mm256_set1_epi16(0x84));
+    __m256i multiplier = _mm256_and_si256(_mm256_shuffle_epi8(_mm256_setr_epi8(ULAW_DECODE_SHIFT, ULAW_DECODE_SHIFT), seg), _mm256_set1_epi16(0xFF));
+    t = _mm256_sub_epi16(_mm256_mullo_epi16(t, multiplier), _mm256_set1_epi16(0x84));
+    __m256i negative = _mm256_cmpeq_epi16(_mm256_and_si256(value, _mm256_set1_epi16(0x80)), _mm256_set1_epi16(0x80));
+    return _mm256_sub_epi16(_mm256_xor_si256(t, negative), negative);
+}
+
+G711_TARGET("avx2")
+static void avx2_encode_alaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 32 <= samples; i += 32) {
+        __m256i low = avx2_alaw(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pcm + i)));
+        __m256i high = avx2_alaw(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pcm + i + 16)));
+        //packus interleaves the 128 bit lanes, permute brings them back in order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    sse_encode_alaw(pcm + i, samples - i, out + i);
+}
+
+G711_TARGET("avx2")
+static void avx2_encode_ulaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 32 <= samples; i += 32) {
+        __m256i low = avx2_ulaw(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pcm + i)));
+        __m256i high = avx2_ulaw(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pcm + i + 16)));
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    sse_encode_ulaw(pcm + i, samples - i, out + i);
+}
+
+G711_TARGET("avx2")
+static void avx2_decode_alaw(const uint8_t* alaw, size_t samples, int16_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        __m256i value = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(alaw + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), avx2_alaw_to_linear(value));
+    }
+    sse_decode_alaw(alaw + i, samples - i, out + i);
+}
+
+G711_TARGET("avx2")
+static void avx2_decode_ulaw(const uint8_t* ulaw, size_t samples, int16_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        __m256i value = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ulaw + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), avx2_ulaw_to_linear(value));
+    }
+    sse_decode_ulaw(ulaw + i, samples - i, out + i);
+}
+
+#if defined(_MSC_VER)
+
+//MSVC has no __builtin_cpu_supports, the features are read with cpuid. AVX2 also needs the
+//OS to save the ymm-registers (OSXSAVE and XCR0 bits 1-2).
+G711_TARGET("xsave")
+static bool os_saves_ymm() {
+    return (_xgetbv(0) & 0x6) == 0x6;
+}
+
+static bool cpu_supports_sse41() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) && (info[2] & (1 << 19));    //SSSE3 (pshufb) and SSE4.1
+}
+
+static bool cpu_supports_avx2() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || !os_saves_ymm()) {    //OSXSAVE, AVX
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+#endif // _MSC_VER
+
+#endif // G711_X86_SIMD
+
+struct G711Kernels {
+    void (*encode_alaw)(const int16_t*, size_t, uint8_t*);
+    void (*encode_ulaw)(const int16_t*, size_t, uint8_t*);
+    void (*decode_alaw)(const uint8_t*, size_t, int16_t*);
+    void (*decode_ulaw)(const uint8_t*, size_t, int16_t*);
+    const char* name;
+};
+
+static G711Kernels select_kernels() {
+#ifdef G711_X86_SIMD
+#if defined(_MSC_VER)
+    bool avx2 = cpu_supports_avx2();
+    bool sse41 = cpu_supports_sse41();
+#else
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2");
+    bool sse41 = __builtin_cpu_supports("sse4.1");
+#endif
+    if (avx2) {
+        return {avx2_encode_alaw, avx2_encode_ulaw, avx2_decode_alaw, avx2_decode_ulaw, "avx2"};
+    }
+    if (sse41) {
+        return {sse_encode_alaw, sse_encode_ulaw, sse_decode_alaw, sse_decode_ulaw, "sse4.1"};
+    }
+#endif
+    return {scalar_encode_alaw, scalar_encode_ulaw, scalar_decode_alaw, scalar_decode_ulaw, "scalar"};
+}
+
+static const G711Kernels& kernels() {
+    static const G711Kernels selected = select_kernels();
+    return selected;
+}
+
+const char* G711::implementation() {
+    return kernels().name;
+}
+
+void G711::encode_alaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    kernels().encode_alaw(pcm, samples, out);
+}
+
+void G711::encode_ulaw(const int16_t* pcm, size_t samples, uint8_t* out) {
+    kernels().encode_ulaw(pcm, samples, out);
+}
+
+void G711::decode_alaw(const uint8_t* alaw, size_t samples, int16_t* out) {
+    kernels().decode_alaw(alaw, samples, out);
+}
+
+void G711::decode_ulaw(const uint8_t* ulaw, size_t samples, int16_t* out) {
+    kernels().decode_ulaw(ulaw, samples, out);
+}
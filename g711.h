@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file g711.h/cpp:
+ *The G711-Class contains the ITU-T G.711 A-law (PCMA) and u-law (PCMU)
+ *converters between 16 bit linear PCM and the 8 bit companded samples.
+ *The single-sample functions follow the well known Sun reference
+ *implementation bit-exactly, the block functions convert a complete frame.
+ *The block functions use SSE4.1 or AVX2 if the CPU supports it (selected
+ *once at runtime, with GCC/Clang and MSVC) and are bit-exact to the
+ *single-sample functions.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef G711_H
+#define G711_H
+
+#include <cstddef>
+#include <cstdint>
+
+class G711 {
+
+public:
+    static uint8_t linear_to_alaw(int16_t pcm);
+    static uint8_t linear_to_ulaw(int16_t pcm);
+    static int16_t alaw_to_linear(uint8_t alaw);
+    static int16_t ulaw_to_linear(uint8_t ulaw);
+
+    //Name of the block-implementation in use: "avx2", "sse4.1" or "scalar"
+    static const char* implementation();
+
+    static void encode_alaw(const int16_t* pcm, size_t samples, uint8_t* out);
+    static void encode_ulaw(const int16_t* pcm, size_t samples, uint8_t* out);
+    static void decode_alaw(const uint8_t* alaw, size_t samples, int16_t* out);
+    static void decode_ulaw(const uint8_t* ulaw, size_t samples, int16_t* out);
+};
+
+#endif // G711_H
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file g722encoder.h/cpp:
+ *The G722Encoder-Class is a plain C++ implementation of the ITU-T G.722
+ *64 kbit/s sub-band ADPCM encoder (based on the public ITU-T reference
+ *algorithm, in the structure known from spandsp). It is used by the
+ *RtpAudioAsset to encode audio-files once at load time, so it is written
+ *for correctness and readability and not for speed.
+ *Input are 16 kHz 16 bit linear samples, output is one byte per two
+ *input samples.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "g722encoder.h"
+
+#include <cstring>
+
+static const int q6[32] = {
+    0, 35, 72, 110, 150, 190, 233, 276, 323, 370, 422, 473, 530, 587, 650, 714,
+    786, 858, 940, 1023, 1121, 1219, 1339, 1458, 1612, 1765, 1980, 2195, 2557, 2919, 0, 0
+};
+static const int iln[32] = {
+    0, 63, 62, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19,
+    18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 0
+};
+static const int ilp[32] = {
+    0, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47,
+    46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 0
+};
+static const int wl[8] = {-60, -30, 58, 172, 334, 538, 1198, 3042};
+static const int rl42[16] = {0, 7, 6, 5, 4, 3, 2, 1, 7, 6, 5, 4, 3, 2, 1, 0};
+static const int ilb[32] = {
+    2048, 2093, 2139, 2186, 2233, 2282, 2332, 2383, 2435, 2489, 2543, 2599, 2656, 2714, 2774, 2834,
+    2896, 2960, 3025, 3091, 3158, 3228, 3298, 3371, 3444, 3520, 3597, 3676, 3756, 3838, 3922, 4008
+};
+static const int qm4[16] = {
+    0, -20456, -12896, -8968, -6288, -4240, -2584, -1200,
+    20456, 12896, 8968, 6288, 4240, 2584, 1200, 0
+};
+static const int qm2[4] = {-7408, -1616, 7408, 1616};
+static const int qmf_coeffs[12] = {3, -11, 12, 32, -210, 951, 3876, -805, 362, -156, 53, -11};
+static const int ihn[3] = {0, 1, 0};
+static const int ihp[3] = {0, 3, 2};
+static const int wh[3] = {0, -214, 798};
+static const int rh2[4] = {2, 1, 2, 1};
+
+static inline int saturate(int amp) {
+    if (amp > 32767) return 32767;
+    if (amp < -32768) return -32768;
+    return amp;
+}
+
+static inline int scale(int nb, int shift_base) {
+    int wd1 = (nb >> 6) & 31;
+    int wd2 = shift_base - (nb >> 11);
+    int wd3 = (wd2 < 0) ? (ilb[wd1] << -wd2) : (ilb[wd1] >> wd2);
+    return wd3 << 2;
+}
+
+G722Encoder::G722Encoder() {
+    G722Encoder::reset();
+}
+
+void G722Encoder::reset() {
+    memset(m_x, 0, sizeof(m_x));
+    memset(m_band, 0, sizeof(m_band));
+    m_band[0].det = 32;
+    m_band[1].det = 8;
+}
+
+//Adaptive predictor (ITU-T G.722 block 4), shared by low- and high-band
+void G722Encoder::block4(Band& band, int d) {
+    //RECONS
+    band.d[0] = d;
+    band.r[0] = saturate(band.s + d);
+
+    //PARREC
+    band.p[0] = saturate(band.sz + d);
+
+    //UPPOL2
+    for (int i = 0; i < 3; i++) {
+        band.sg[i] = band.p[i] >> 15;
+    }
+    int wd1 = saturate(band.a[1] << 2);
+    int wd2 = (band.sg[0] == band.sg[1]) ? -wd1 : wd1;
+    if (wd2 > 32767) {
+        wd2 = 32767;
+    }
+    int wd3 = (wd2 >> 7) + ((band.sg[0] == band.sg[2]) ? 128 : -128);
+    wd3 += (band.a[2] * 32512) >> 15;
+    if (wd3 > 12288) {
+        wd3 = 12288;
+    } else if (wd3 < -12288) {
+        wd3 = -12288;
+    }
+    band.ap[2] = wd3;
+
+    //UPPOL1
+    band.sg[0] = band.p[0] >> 15;
+    band.sg[1] = band.p[1] >> 15;
+    wd1 = (band.sg[0] == band.sg[1]) ? 192 : -192;
+    wd2 = (band.a[1] * 32640) >> 15;
+    band.ap[1] = saturate(wd1 + wd2);
+    wd3 = saturate(15360 - band.ap[2]);
+    if (band.ap[1] > wd3) {
+        band.ap[1] = wd3;
+    } else if (band.ap[1] < -wd3) {
+        band.ap[1] = -wd3;
+    }
+
+    //UPZERO
+    wd1 = (d == 0) ? 0 : 128;
+    band.sg[0] = d >> 15;
+    for (int i = 1; i < 7; i++) {
+        band.sg[i] = band.d[i] >> 15;
+        wd2 = (band.sg[i] == band.sg[0]) ? wd1 : -wd1;
+        wd3 = (band.b[i] * 32640) >> 15;
+        band.bp[i] = saturate(wd2 + wd3);
+    }
+
+    //DELAYA
+    for (int i = 6; i > 0; i--) {
+        band.d[i] = band.d[i - 1];
+        band.b[i] = band.bp[i];
+    }
+    for (int i = 2; i > 0; i--) {
+        band.r[i] = band.r[i - 1];
+        band.p[i] = band.p[i - 1];
+        band.a[i] = band.ap[i];
+    }
+
+    //FILTEP
+    wd1 = saturate(band.r[1] + band.r[1]);
+    wd1 = (band.a[1] * wd1) >> 15;
+    wd2 = saturate(band.r[2] + band.r[2]);
+    wd2 = (band.a[2] * wd2) >> 15;
+    band.sp = saturate(wd1 + wd2);
+
+    //FILTEZ
+    band.sz = 0;
+    for (int i = 6; i > 0; i--) {
+        wd1 = saturate(band.d[i] + band.d[i]);
+        band.sz += (band.b[i] * wd1) >> 15;
+    }
+    band.sz = saturate(band.sz);
+
+    //PREDIC
+    band.s = saturate(band.sp + band.sz);
+}
+
+void G722Encoder::encode(const int16_t* pcm, size_t samples, uint8_t* out) {
+    for (size_t j = 0; j + 1 < samples; j += 2) {
+        //Transmit QMF: split into low- and high-band, every other output is discarded
+        memmove(m_x, m_x + 2, 22 * sizeof(int));
+        m_x[22] = pcm[j];
+        m_x[23] = pcm[j + 1];
+
+        int sumeven = 0;
+        int sumodd = 0;
+        for (int i = 0; i < 12; i++) {
+            sumodd += m_x[2 * i] * qmf_coeffs[i];
+            sumeven += m_x[2 * i + 1] * qmf_coeffs[11 - i];
+        }
+        int xlow = (sumeven + sumodd) >> 14;
+        int xhigh = (sumeven - sumodd) >> 14;
+
+        //Low-band: SUBTRA, QUANTL
+        Band& low = m_band[0];
+        int el = saturate(xlow - low.s);
+        int wd = (el >= 0) ? el : -(el + 1);
+        int i = 1;
+        for (; i < 30; i++) {
+            int wd1 = (q6[i] * low.det) >> 12;
+            if (wd < wd1) {
+                break;
+            }
+        }
+        int ilow = (el < 0) ? iln[i] : ilp[i];
+
+        //INVQAL, LOGSCL, SCALEL
+        int ril = ilow >> 2;
+        int dlow = (low.det * qm4[ril]) >> 15;
+        low.nb = ((low.nb * 127) >> 7) + wl[rl42[ril]];
+        if (low.nb < 0) {
+            low.nb = 0;
+        } else if (low.nb > 18432) {
+            low.nb = 18432;
+        }
+        low.det = scale(low.nb, 8);
+        G722Encoder::block4(low, dlow);
+
+        //High-band: SUBTRA, QUANTH
+        Band& high = m_band[1];
+        int eh = saturate(xhigh - high.s);
+        wd = (eh >= 0) ? eh : -(eh + 1);
+        int mih = (wd >= ((564 * high.det) >> 12)) ? 2 : 1;
+        int ihigh = (eh < 0) ? ihn[mih] : ihp[mih];
+
+        //INVQAH, LOGSCH, SCALEH
+        int dhigh = (high.det * qm2[ihigh]) >> 15;
+        high.nb = ((high.nb * 127) >> 7) + wh[rh2[ihigh]];
+        if (high.nb < 0) {
+            high.nb = 0;
+        } else if (high.nb > 22528) {
+            high.nb = 22528;
+        }
+        high.det = scale(high.nb, 10);
+        G722Encoder::block4(high, dhigh);
+
+        *out++ = uint8_t((ihigh << 6) | ilow);
+    }
+}
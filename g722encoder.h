@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file g722encoder.h/cpp:
+ *The G722Encoder-Class is a plain C++ implementation of the ITU-T G.722
+ *64 kbit/s sub-band ADPCM encoder (based on the public ITU-T reference
+ *algorithm, in the structure known from spandsp). It is used by the
+ *RtpAudioAsset to encode audio-files once at load time, so it is written
+ *for correctness and readability and not for speed.
+ *Input are 16 kHz 16 bit linear samples, output is one byte per two
+ *input samples.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef G722ENCODER_H
+#define G722ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+class G722Encoder {
+
+public:
+    G722Encoder();
+
+    void reset();
+    //samples has to be even, writes samples / 2 bytes to out
+    void encode(const int16_t* pcm, size_t samples, uint8_t* out);
+
+private:
+    struct Band {
+        int s;
+        int sp;
+        int sz;
+        int r[3];
+        int a[3];
+        int ap[3];
+        int p[3];
+        int d[7];
+        int b[7];
+        int bp[7];
+        int sg[7];
+        int nb;
+        int det;
+    };
+
+    static void block4(Band& band, int d);
+
+    int m_x[24];
+    Band m_band[2];
+};
+
+#endif // G722ENCODER_H
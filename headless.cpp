@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file headless.cpp:
+ *This is the entry-point of the headless target RTP-Generator-Headless.
+ *It starts only a QCoreApplication (no widgets, no rendering) and hands
+ *the command-line/config-file settings over to the HeadlessRunner.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "headlessrunner.h"
+#include "siptxplan.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("RTPEngine");
+    QCoreApplication::setApplicationVersion("v0.2");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless RTP-Generator: SIP-call and RTP-streams without GUI");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"config", "JSON config-file, command-line options overwrite it.", "file"},
+        {"user", "SIP user for the registration.", "user"},
+        {"password", "SIP password.", "password"},
+        {"proxy", "SIP proxy/registrar IP.", "ip"},
+        {"call", "Destination to call after the registration.", "number"},
+        {"sip-log", "Print the complete SIP-messages."},
+        {"tx-trace", "Log every header-rewrite of the TX-hook."},
+        {"sip-transport", "SIP transport: udp, tcp or tls.", "type"},
+        {"sip-local-port", "First local SIP port, 0 = any.", "port"},
+        {"sip-connections", "Transports (persistent connections) shared by all accounts.", "count"},
+        {"proxy-port", "SIP proxy port, default 5060 (TLS 5061).", "port"},
+        {"tls-ca", "TLS CA-list file.", "file"},
+        {"tls-cert", "TLS certificate file.", "file"},
+        {"tls-key", "TLS private-key file.", "file"},
+        {"tls-verify", "Verify the TLS certificate of the proxy."},
+        {"media", "Call media: null (default, silence), file, tone or sound.", "mode"},
+        {"media-file", "WAV-file played into every call (media file).", "file"},
+        {"tone", "Tone frequency for media tone.", "hz"},
+        {"call-rtp", "The RTP-stream is sent to the negotiated media of the call, PJSIP does not send."},
+        {"sip-workers", "PJSIP worker-threads.", "count"},
+        {"sip-handlers", "Handler-threads for call/registration events, 0 = main-thread.", "count"},
+        {"sip-log-level", "PJSIP log-level 0..6, below 4 no SIP-messages are shown.", "level"},
+        {"header-rules", "JSON-file with header-rules for all outgoing SIP-messages.", "file"},
+        {"load-accounts", "Call-load: csv-file with one user;password per line.", "file"},
+        {"load-call", "Call-load: destination of the load-calls.", "number"},
+        {"cps", "Call-load: calls per second.", "rate"},
+        {"max-calls", "Call-load: maximum of parallel calls, at most PJSUA_MAX_CALLS of the PJSIP build (stock: 32).", "count"},
+        {"calls", "Call-load: total calls, 0 = until stopped.", "count"},
+        {"hold", "Call-load: hold time of a connected call in ms.", "ms"},
+        {"no-rtp", "Do not send RTP."},
+        {"payload-type", "PCMA, PCMU or G722.", "type"},
+        {"rtp-destination", "RTP destination IP.", "ip"},
+        {"rtp-port", "RTP destination port.", "port"},
+        {"ptime", "Packetization time in ms.", "ms"},
+        {"count", "Pakets per stream, 0 = endless.", "count"},
+        {"stream-list", "Stream-list for the RTP load-mode.", "file"},
+        {"workers", "Worker-threads for the RTP load-mode, 0 = one per core.", "count"},
+        {"scenario", "RTP scenario-file (JSON).", "file"},
+        {"audio", "WAV/raw audio-file as RTP payload.", "file"},
+        {"rtcp-interval", "RTCP report interval in ms, 0 = no RTCP.", "ms"},
+        {"event-pt", "Telephone-event payload type of the stream, a call uses the negotiated one.", "pt"},
+        {"dtmf", "DTMF-digits (RFC 4733) fired on every stream with a telephone-event payload type.", "digits"},
+        {"dtmf-at", "Seconds after the RTP-start the DTMF is fired.", "seconds"},
+        {"dtmf-interval", "Repeat the DTMF every n seconds, 0 = once.", "seconds"},
+        {"dtmf-duration", "Duration of one DTMF-event in ms.", "ms"},
+        {"dtmf-pause", "Pause between two DTMF-events in ms.", "ms"},
+        {"dtmf-volume", "Volume of the DTMF-events in -dBm0 (0..63).", "level"},
+        {"rtp-listen", "Receive and analyse RTP from this port on.", "port"},
+        {"rtp-listen-ports", "Number of consecutive receive-ports.", "count"},
+        {"rtp-listen-threads", "Receive-threads, 0 = one per core.", "count"},
+        {"duration", "Stop after this many seconds, 0 = until SIGINT.", "seconds"},
+    });
+    parser.process(a);
+
+    HeadlessConfig config;
+    if (parser.isSet("config") && !config.load(parser.value("config"))) {
+        return 1;
+    }
+    if (parser.isSet("user")) {
+        config.user = parser.value("user");
+    }
+    if (parser.isSet("password")) {
+        config.password = parser.value("password");
+    }
+    if (parser.isSet("proxy")) {
+        config.proxy = parser.value("proxy");
+    }
+    if (parser.isSet("call")) {
+        config.call_destination = parser.value("call");
+    }
+    if (parser.isSet("sip-log")) {
+        config.sip_log = true;
+    }
+    if (parser.isSet("tx-trace")) {
+        SipTxPlan::set_trace_level(1);
+    }
+    if (parser.isSet("sip-transport") && !HeadlessConfig::parse_transport_type(parser.value("sip-transport"), config.transport.type)) {
+        return 1;
+    }
+    if (parser.isSet("sip-local-port")) {
+        config.transport.local_port = quint16(parser.value("sip-local-port").toUInt());
+    }
+    if (parser.isSet("sip-connections")) {
+        config.transport.connections = parser.value("sip-connections").toInt();
+    }
+    if (parser.isSet("proxy-port")) {
+        config.transport.proxy_port = quint16(parser.value("proxy-port").toUInt());
+    }
+    if (parser.isSet("tls-ca")) {
+        config.transport.tls_ca_file = parser.value("tls-ca");
+    }
+    if (parser.isSet("tls-cert")) {
+        config.transport.tls_cert_file = parser.value("tls-cert");
+    }
+    if (parser.isSet("tls-key")) {
+        config.transport.tls_key_file = parser.value("tls-key");
+    }
+    if (parser.isSet("tls-verify")) {
+        config.transport.tls_verify_server = true;
+    }
+    if (parser.isSet("media") && !SipMediaConfig::parse_mode(parser.value("media"), config.media.mode)) {
+        return 1;
+    }
+    if (parser.isSet("media-file")) {
+        config.media.file = parser.value("media-file");
+    }
+    if (parser.isSet("tone")) {
+        config.media.tone_hz = parser.value("tone").toInt();
+    }
+    if (parser.isSet("call-rtp")) {
+        config.call_rtp = true;
+    }
+    if (parser.isSet("sip-workers")) {
+        config.sip_workers = parser.value("sip-workers").toInt();
+    }
+    if (parser.isSet("sip-handlers")) {
+        config.sip_handlers = parser.value("sip-handlers").toInt();
+    }
+    if (parser.isSet("sip-log-level")) {
+        config.sip_log_level = parser.value("sip-log-level").toInt();
+    }
+    if (parser.isSet("header-rules")) {
+        config.header_rules = parser.value("header-rules");
+    }
+    if (parser.isSet("load-accounts")) {
+        config.load_accounts = parser.value("load-accounts");
+    }
+    if (parser.isSet("load-call")) {
+        config.call_load.destination = parser.value("load-call");
+    }
+    if (parser.isSet("cps")) {
+        config.call_load.cps = parser.value("cps").toDouble();
+    }
+    if (parser.isSet("max-calls")) {
+        config.call_load.max_concurrent = parser.value("max-calls").toInt();
+    }
+    if (parser.isSet("calls")) {
+        config.call_load.total_calls = parser.value("calls").toULongLong();
+    }
+    if (parser.isSet("hold")) {
+        config.call_load.hold_ms = parser.value("hold").toInt();
+    }
+    if (parser.isSet("no-rtp")) {
+        config.rtp = false;
+    }
+    if (parser.isSet("payload-type")) {
+        config.stream.payload_type = parser.value("payload-type");
+    }
+    if (parser.isSet("rtp-destination")) {
+        config.stream.destination = QHostAddress(parser.value("rtp-destination"));
+    }
+    if (parser.isSet("rtp-port")) {
+        config.stream.port = quint16(parser.value("rtp-port").toUInt());
+    }
+    if (parser.isSet("ptime")) {
+        config.stream.ptime_ms = parser.value("ptime").toInt();
+    }
+    if (parser.isSet("count")) {
+        config.stream.packet_count = parser.value("count").toULongLong();
+    }
+    if (parser.isSet("stream-list")) {
+        config.stream_list = parser.value("stream-list");
+    }
+    if (parser.isSet("workers")) {
+        config.workers = parser.value("workers").toInt();
+    }
+    if (parser.isSet("scenario")) {
+        config.scenario = parser.value("scenario");
+    }
+    if (parser.isSet("audio")) {
+        config.audio = parser.value("audio");
+    }
+    if (parser.isSet("rtcp-interval")) {
+        config.rtcp_interval_ms = parser.value("rtcp-interval").toInt();
+    }
+    if (parser.isSet("event-pt")) {
+        config.stream.event_payload_type = parser.value("event-pt").toInt();
+    }
+    if (parser.isSet("dtmf")) {
+        config.dtmf.digits = parser.value("dtmf");
+    }
+    if (parser.isSet("dtmf-at")) {
+        config.dtmf_at_ms = int(parser.value("dtmf-at").toDouble() * 1000);
+    }
+    if (parser.isSet("dtmf-interval")) {
+        config.dtmf_interval_ms = int(parser.value("dtmf-interval").toDouble() * 1000);
+    }
+    if (parser.isSet("dtmf-duration")) {
+        config.dtmf.duration_ms = parser.value("dtmf-duration").toInt();
+    }
+    if (parser.isSet("dtmf-pause")) {
+        config.dtmf.pause_ms = parser.value("dtmf-pause").toInt();
+    }
+    if (parser.isSet("dtmf-volume")) {
+        config.dtmf.volume = parser.value("dtmf-volume").toInt();
+    }
+    if (parser.isSet("rtp-listen")) {
+        config.rtp_receive = true;
+        config.receive.first_port = quint16(parser.value("rtp-listen").toUInt());
+    }
+    if (parser.isSet("rtp-listen-ports")) {
+        config.receive.port_count = parser.value("rtp-listen-ports").toInt();
+    }
+    if (parser.isSet("rtp-listen-threads")) {
+        config.receive.threads = parser.value("rtp-listen-threads").toInt();
+    }
+    if (parser.isSet("duration")) {
+        config.duration_s = parser.value("duration").toInt();
+    }
+
+    HeadlessRunner runner;
+    if (!runner.start(config)) {
+        fprintf(stderr, "Failed to start, see log above\n");
+        return 1;
+    }
+    return a.exec();
+}
@@ -0,0 +1,480 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file headlessrunner.h/cpp:
+ *The HeadlessRunner-Class drives SipMachine and RtpEngine without any
+ *widget. It is used by the headless target RTP-Generator-Headless
+ *(see headless.cpp) on test hosts without a display. All settings come
+ *from a JSON config-file and/or command-line arguments (HeadlessConfig),
+ *the SIP-flow and the RTP-statistics are printed to stdout.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "headlessrunner.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+#include <csignal>
+
+//Set from the signal-handler, polled by the runner (a signal-handler may not call into Qt)
+static std::atomic<bool> stop_requested(false);
+
+static void on_stop_signal(int) {
+    stop_requested = true;
+}
+
+bool HeadlessConfig::load(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open config:" << path;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (doc.isNull() || !doc.isObject()) {
+        qWarning() << "Invalid config" << path << ":" << error.errorString();
+        return false;
+    }
+
+    //Only present keys overwrite the defaults
+    QJsonObject root = doc.object();
+    QJsonObject sip = root.value("sip").toObject();
+    user = sip.value("user").toString(user);
+    password = sip.value("password").toString(password);
+    proxy = sip.value("proxy").toString(proxy);
+    call_destination = sip.value("call").toString(call_destination);
+    sip_log = sip.value("log").toBool(sip_log);
+    header_rules = sip.value("header_rules").toString(header_rules);
+    sip_workers = sip.value("workers").toInt(sip_workers);
+    sip_handlers = sip.value("handlers").toInt(sip_handlers);
+    sip_log_level = sip.value("log_level").toInt(sip_log_level);
+
+    QJsonObject transport_config = sip.value("transport").toObject();
+    if (transport_config.contains("type") && !parse_transport_type(transport_config.value("type").toString(), transport.type)) {
+        return false;
+    }
+    transport.local_port = quint16(transport_config.value("local_port").toInt(transport.local_port));
+    transport.connections = transport_config.value("connections").toInt(transport.connections);
+    transport.proxy_port = quint16(transport_config.value("proxy_port").toInt(transport.proxy_port));
+    transport.tls_ca_file = transport_config.value("tls_ca").toString(transport.tls_ca_file);
+    transport.tls_cert_file = transport_config.value("tls_cert").toString(transport.tls_cert_file);
+    transport.tls_key_file = transport_config.value("tls_key").toString(transport.tls_key_file);
+    transport.tls_verify_server = transport_config.value("tls_verify").toBool(transport.tls_verify_server);
+
+    QJsonObject media_config = sip.value("media").toObject();
+    if (media_config.contains("mode") && !SipMediaConfig::parse_mode(media_config.value("mode").toString(), media.mode)) {
+        return false;
+    }
+    media.file = media_config.value("file").toString(media.file);
+    media.tone_hz = media_config.value("tone_hz").toInt(media.tone_hz);
+    call_rtp = sip.value("call_rtp").toBool(call_rtp);
+
+    QJsonObject call_setup = sip.value("call_setup").toObject();
+    setup.gatekeeper = call_setup.value("gatekeeper").toBool(setup.gatekeeper);
+    setup.disable_update = call_setup.value("disable_update").toBool(setup.disable_update);
+    setup.supp_rel = call_setup.value("supp_rel").toBool(setup.supp_rel);
+    setup.req_rel = call_setup.value("req_rel").toBool(setup.req_rel);
+    setup.supp_timer = call_setup.value("supp_timer").toBool(setup.supp_timer);
+    setup.req_timer = call_setup.value("req_timer").toBool(setup.req_timer);
+    setup.refresher = call_setup.value("refresher").toString(setup.refresher);
+
+    QJsonObject load_config = sip.value("load").toObject();
+    load_accounts = load_config.value("accounts").toString(load_accounts);
+    call_load.destination = load_config.value("call").toString(call_load.destination);
+    call_load.cps = load_config.value("cps").toDouble(call_load.cps);
+    call_load.max_concurrent = load_config.value("max_calls").toInt(call_load.max_concurrent);
+    call_load.total_calls = quint64(load_config.value("calls").toDouble(double(call_load.total_calls)));
+    call_load.hold_ms = load_config.value("hold").toInt(call_load.hold_ms);
+
+    QJsonObject rtp_config = root.value("rtp").toObject();
+    rtp = rtp_config.value("enabled").toBool(rtp);
+    stream.payload_type = rtp_config.value("payload_type").toString(stream.payload_type);
+    if (rtp_config.contains("destination")) {
+        stream.destination = QHostAddress(rtp_config.value("destination").toString());
+    }
+    stream.port = quint16(rtp_config.value("port").toInt(stream.port));
+    stream.ptime_ms = rtp_config.value("ptime").toInt(stream.ptime_ms);
+    stream.packet_count = quint64(rtp_config.value("count").toDouble(double(stream.packet_count)));
+    stream.ssrc = rtp_config.value("ssrc").toString(stream.ssrc);
+    stream_list = rtp_config.value("stream_list").toString(stream_list);
+    workers = rtp_config.value("workers").toInt(workers);
+    scenario = rtp_config.value("scenario").toString(scenario);
+    audio = rtp_config.value("audio").toString(audio);
+    rtcp_interval_ms = rtp_config.value("rtcp_interval").toInt(rtcp_interval_ms);
+    stream.event_payload_type = rtp_config.value("event_payload_type").toInt(stream.event_payload_type);
+
+    QJsonObject dtmf_config = rtp_config.value("dtmf").toObject();
+    dtmf.digits = dtmf_config.value("digits").toString(dtmf.digits);
+    dtmf.duration_ms = dtmf_config.value("duration").toInt(dtmf.duration_ms);
+    dtmf.pause_ms = dtmf_config.value("pause").toInt(dtmf.pause_ms);
+    dtmf.volume = dtmf_config.value("volume").toInt(dtmf.volume);
+    dtmf_at_ms = int(dtmf_config.value("at").toDouble(dtmf_at_ms / 1000.0) * 1000);
+    dtmf_interval_ms = int(dtmf_config.value("interval").toDouble(dtmf_interval_ms / 1000.0) * 1000);
+
+    QJsonObject receive_config = root.value("rtp_receive").toObject();
+    rtp_receive = receive_config.value("enabled").toBool(rtp_receive || !receive_config.isEmpty());
+    if (receive_config.contains("address")) {
+        receive.bind_address = QHostAddress(receive_config.value("address").toString());
+    }
+    receive.first_port = quint16(receive_config.value("port").toInt(receive.first_port));
+    receive.port_count = receive_config.value("ports").toInt(receive.port_count);
+    receive.threads = receive_config.value("threads").toInt(receive.threads);
+
+    duration_s = root.value("duration").toInt(duration_s);
+    return true;
+}
+
+bool HeadlessConfig::parse_transport_type(const QString& name, SipTransportConfig::Type& type) {
+    QString lower = name.toLower();
+    if (lower == "udp") {
+        type = SipTransportConfig::Udp;
+    } else if (lower == "tcp") {
+        type = SipTransportConfig::Tcp;
+    } else if (lower == "tls") {
+        type = SipTransportConfig::Tls;
+    } else {
+        qWarning() << "Unknown SIP transport:" << name;
+        return false;
+    }
+    return true;
+}
+
+HeadlessRunner::HeadlessRunner(QObject* parent)
+    : QObject(parent), m_rtp_engine(new RtpEngine(this)), m_rtp_receiver(new RtpReceiver(this)), m_out(stdout) {
+
+    connect(m_rtp_engine, &RtpEngine::stream_stats, this, &HeadlessRunner::on_rtp_stream_stats, Qt::QueuedConnection);
+    connect(m_rtp_receiver, &RtpReceiver::receive_stats, this, &HeadlessRunner::on_rtp_receive_stats, Qt::QueuedConnection);
+    connect(m_rtp_engine, &RtpEngine::stopped, this, [this]() {
+        //All streams sent their pakets - without SIP or receiver there is nothing left to do
+        if (!m_sip && !m_rtp_receiver->is_running()) {
+            HeadlessRunner::stop();
+        }
+    });
+
+    m_dtmf_timer.setSingleShot(true);
+    connect(&m_dtmf_timer, &QTimer::timeout, this, &HeadlessRunner::on_dtmf_timer);
+
+    std::signal(SIGINT, on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
+    m_signal_timer.setInterval(100);
+    connect(&m_signal_timer, &QTimer::timeout, this, [this]() {
+        if (stop_requested) {
+            HeadlessRunner::stop();
+        }
+    });
+}
+
+HeadlessRunner::~HeadlessRunner() {
+    m_rtp_engine->stop();
+    m_rtp_receiver->stop();
+}
+
+bool HeadlessRunner::start(const HeadlessConfig& config) {
+    m_config = config;
+    m_signal_timer.start();
+
+    //PJSIP is only initialized if SIP is really used, this keeps the start fast
+    if (!m_config.user.isEmpty() || !m_config.load_accounts.isEmpty()) {
+        m_sip = new SipMachine(this);
+        m_sip->set_threading(m_config.sip_workers, m_config.sip_handlers);
+        m_sip->set_transport(m_config.transport);
+        m_sip->set_media(m_config.media);
+        m_sip->set_log_level(m_config.sip_log_level);
+        m_sip->set_custom_rtp(m_config.call_rtp);
+        connect(m_sip, &SipMachine::registration_state_changed, this, &HeadlessRunner::on_registration_state_changed);
+        connect(m_sip, &SipMachine::new_sip_message, this, &HeadlessRunner::on_sip_message);
+        connect(m_sip, &SipMachine::call_media_ready, this, &HeadlessRunner::on_call_media_ready);
+        connect(m_sip, &SipMachine::call_media_ended, this, &HeadlessRunner::on_call_media_ended);
+
+        if (!m_config.header_rules.isEmpty()) {
+            SipHeaderRules rules;
+            if (!SipHeaderRules::load(m_config.header_rules, rules)) {
+                return false;
+            }
+            m_sip->set_header_rules(rules);
+        }
+    }
+    if (!m_config.user.isEmpty()) {
+        if (!m_sip->create_account(m_config.user, m_config.proxy, m_config.password, m_config.setup)) {
+            qWarning() << "Failed to create SIP account";
+            return false;
+        }
+    }
+    if (!m_config.load_accounts.isEmpty()) {
+        //The load waits for registered accounts, the calls start with the first 200 OK on REGISTER
+        if (m_sip->create_load_accounts(m_config.load_accounts, m_config.proxy, m_config.setup) == 0) {
+            qWarning() << "No load-accounts created from" << m_config.load_accounts;
+            return false;
+        }
+        m_call_load = new SipCallLoad(m_sip, this);
+        connect(m_call_load, &SipCallLoad::metrics_updated, this, &HeadlessRunner::on_call_load_metrics);
+        connect(m_call_load, &SipCallLoad::finished, this, &HeadlessRunner::stop);
+        if (!m_call_load->start(m_config.call_load)) {
+            return false;
+        }
+    }
+
+    if (m_config.rtp_receive) {
+        m_receive_stats.clear();
+        m_receive_timer.start();
+        if (!m_rtp_receiver->start(m_config.receive)) {
+            return false;
+        }
+    }
+    //With call-rtp the stream waits for the media of the call
+    bool call_rtp = m_sip && m_config.call_rtp;
+    if (m_config.rtp && !call_rtp && !HeadlessRunner::start_rtp()) {
+        return false;
+    }
+
+    if (m_config.duration_s > 0) {
+        QTimer::singleShot(m_config.duration_s * 1000, this, &HeadlessRunner::stop);
+    }
+    return true;
+}
+
+bool HeadlessRunner::start_rtp(const SipCallMedia& media) {
+    std::shared_ptr<const RtpScenario> scenario;
+    if (!m_config.scenario.isEmpty()) {
+        std::shared_ptr<RtpScenario> loaded = std::make_shared<RtpScenario>();
+        if (!RtpScenario::load(m_config.scenario, *loaded)) {
+            return false;
+        }
+        scenario = loaded;
+    }
+
+    std::shared_ptr<const RtpAudioAsset> audio;
+    if (!m_config.audio.isEmpty()) {
+        std::shared_ptr<RtpAudioAsset> loaded = std::make_shared<RtpAudioAsset>();
+        if (!loaded->load(m_config.audio)) {
+            return false;
+        }
+        audio = loaded;
+    }
+
+    QVector<RtpStreamConfig> streams;
+    if (media.call_id >= 0) {
+        RtpStreamConfig stream = m_config.stream;
+        if (!media.stream_config(stream)) {
+            return false;
+        }
+        streams.push_back(stream);
+    } else if (!m_config.stream_list.isEmpty()) {
+        if (!RtpEngine::load_stream_list(m_config.stream_list, streams)) {
+            return false;
+        }
+    } else {
+        streams.push_back(m_config.stream);
+    }
+    for (RtpStreamConfig& stream : streams) {
+        stream.scenario = scenario;
+        stream.audio = audio;
+        //The RTCP of the call's media-socket stays with PJSIP
+        stream.rtcp_interval_ms = stream.socket ? 0 : m_config.rtcp_interval_ms;
+    }
+
+    m_rtp_stats.clear();
+    m_stats_timer.start();
+    if (!m_rtp_engine->start(streams, m_config.workers)) {
+        return false;
+    }
+    if (!m_config.dtmf.digits.isEmpty()) {
+        m_dtmf_timer.start(qMax(0, m_config.dtmf_at_ms));
+    }
+    return true;
+}
+
+void HeadlessRunner::stop() {
+    m_signal_timer.stop();
+    m_dtmf_timer.stop();
+    m_rtp_engine->stop();
+    m_rtp_receiver->stop();
+    if (m_call_load) {
+        m_call_load->stop();
+    }
+    if (m_sip) {
+        m_sip->hangup_call();
+        m_sip->dereg_account();
+    }
+    QCoreApplication::quit();
+}
+
+void HeadlessRunner::on_registration_state_changed(int sip_code, const QString& text) {
+    m_out << "Registration: " << sip_code << " " << text << Qt::endl;
+    if (sip_code == 200 && !m_call_started && !m_config.call_destination.isEmpty()) {
+        m_call_started = true;
+        if (!m_sip->make_call(m_config.call_destination)) {
+            qWarning() << "Failed to call" << m_config.call_destination;
+        }
+    }
+}
+
+void HeadlessRunner::on_call_media_ready(const SipCallMedia& media) {
+    m_out << "Call media: " << media.codec << " pt " << media.payload_type << " to "
+          << media.remote_address.toString() << ":" << media.remote_port << ", ptime " << media.ptime_ms << " ms" << Qt::endl;
+    if (!m_config.rtp || !m_config.call_rtp) {
+        return;
+    }
+    //Every re-negotiation restarts the stream with the new media
+    m_rtp_engine->stop();
+    if (!HeadlessRunner::start_rtp(media)) {
+        qWarning() << "Failed to start RTP for the call";
+    }
+}
+
+void HeadlessRunner::on_call_media_ended(int call_id) {
+    Q_UNUSED(call_id);
+    if (m_config.call_rtp) {
+        m_dtmf_timer.stop();
+        m_rtp_engine->stop();
+    }
+}
+
+void HeadlessRunner::on_dtmf_timer() {
+    if (!m_rtp_engine->send_dtmf(m_config.dtmf)) {
+        return;
+    }
+    m_out << "DTMF: " << m_config.dtmf.digits << Qt::endl;
+    if (m_config.dtmf_interval_ms > 0) {
+        m_dtmf_timer.start(m_config.dtmf_interval_ms);
+    }
+}
+
+void HeadlessRunner::on_sip_message(const SipMessageInfo& info, const QByteArray& message) {
+    //One line per message, the complete message only on request
+    m_out << (info.direction == SipMessageInfo::Tx ? "TX " : "RX ");
+    if (info.is_request) {
+        m_out << SipMessageInfo::method_name(info.method);
+    } else {
+        m_out << info.status_code << " " << SipMessageInfo::method_name(info.method);
+    }
+    m_out << (info.direction == SipMessageInfo::Tx ? " to " : " from ") << info.remote_ip << ":" << info.remote_port << Qt::endl;
+    if (m_config.sip_log) {
+        m_out << message << Qt::endl;
+    }
+}
+
+void HeadlessRunner::on_call_load_metrics(const CallLoadMetrics& metrics) {
+    m_out << "Calls: " << metrics.attempted << " attempted, " << metrics.active << " active, "
+          << metrics.answered << " answered, " << metrics.failed << " failed, success "
+          << QString::number(metrics.success_ratio * 100.0, 'f', 1) << " %, "
+          << QString::number(metrics.cps, 'f', 1) << " cps, setup 18x "
+          << QString::number(metrics.ringing_mean_ms, 'f', 1) << "/" << QString::number(metrics.ringing_max_ms, 'f', 1)
+          << " ms, 200 " << QString::number(metrics.answer_mean_ms, 'f', 1) << "/"
+          << QString::number(metrics.answer_max_ms, 'f', 1) << " ms (mean/max)" << Qt::endl;
+}
+
+void HeadlessRunner::on_rtp_stream_stats(const QVector<RtpStreamStats>& stats) {
+    for (const RtpStreamStats& stream : stats) {
+        m_rtp_stats.insert(stream.stream_id, stream);
+    }
+
+    //Every worker reports on its own, printed is at most once per second
+    if (m_stats_timer.elapsed() < 1000) {
+        return;
+    }
+    m_stats_timer.restart();
+
+    quint64 packets = 0;
+    double max_lateness_us = 0.0;
+    quint32 resyncs = 0;
+    quint64 rtcp_received = 0;
+    double max_rtt_ms = -1.0;
+    double max_remote_loss = 0.0;
+    quint64 dtmf_events = 0;
+    for (const RtpStreamStats& stream : std::as_const(m_rtp_stats)) {
+        packets += stream.packets_sent;
+        max_lateness_us = qMax(max_lateness_us, stream.max_lateness_us);
+        resyncs += stream.resyncs;
+        dtmf_events += stream.dtmf_events;
+        rtcp_received += stream.rtcp_received;
+        max_rtt_ms = qMax(max_rtt_ms, stream.rtt_ms);
+        max_remote_loss = qMax(max_remote_loss, stream.remote_loss_percent);
+    }
+    RtpTransportStats transport = m_rtp_engine->transport_stats();
+    m_out << "RTP: " << m_rtp_stats.size() << " streams, " << packets << " pakets, max lateness "
+          << QString::number(max_lateness_us, 'f', 1) << " us, resyncs " << resyncs
+          << ", syscalls " << transport.syscalls << ", dropped " << transport.dropped;
+    if (rtcp_received > 0) {
+        m_out << ", RTCP reports " << rtcp_received << ", max RTT "
+              << (max_rtt_ms < 0 ? QString("-") : QString::number(max_rtt_ms, 'f', 1) + " ms")
+              << ", max remote loss " << QString::number(max_remote_loss, 'f', 1) << " %";
+    }
+    if (dtmf_events > 0) {
+        m_out << ", DTMF-events " << dtmf_events;
+    }
+    m_out << Qt::endl;
+}
+
+void HeadlessRunner::on_rtp_receive_stats(const QVector<RtpReceiveStats>& stats) {
+    for (const RtpReceiveStats& stream : stats) {
+        m_receive_stats.insert((quint64(stream.port) << 32) | stream.ssrc, stream);
+    }
+
+    if (m_receive_timer.elapsed() < 1000) {
+        return;
+    }
+    m_receive_timer.restart();
+
+    quint64 packets = 0;
+    qint64 lost = 0;
+    quint64 reordered = 0;
+    quint64 duplicates = 0;
+    double max_jitter_ms = 0.0;
+    double max_gap_ms = 0.0;
+    for (const RtpReceiveStats& stream : std::as_const(m_receive_stats)) {
+        packets += stream.packets;
+        lost += stream.lost;
+        reordered += stream.reordered;
+        duplicates += stream.duplicates;
+        max_jitter_ms = qMax(max_jitter_ms, stream.jitter_ms);
+        max_gap_ms = qMax(max_gap_ms, stream.max_gap_ms);
+    }
+    double expected = double(packets) + double(lost);
+    double loss_percent = expected > 0 ? double(lost) * 100.0 / expected : 0.0;
+    RtpReceiverTotals totals = m_rtp_receiver->totals();
+    m_out << "RTP-RX: " << m_receive_stats.size() << " streams, " << packets << " pakets, lost " << lost
+          << " (" << QString::number(loss_percent, 'f', 2) << " %), max jitter "
+          << QString::number(max_jitter_ms, 'f', 2) << " ms, max gap " << QString::number(max_gap_ms, 'f', 1)
+          << " ms, reordered " << reordered << ", duplicates " << duplicates
+          << ", syscalls " << totals.syscalls << ", invalid " << totals.invalid << Qt::endl;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file headlessrunner.h/cpp:
+ *The HeadlessRunner-Class drives SipMachine and RtpEngine without any
+ *widget. It is used by the headless target RTP-Generator-Headless
+ *(see headless.cpp) on test hosts without a display. All settings come
+ *from a JSON config-file and/or command-line arguments (HeadlessConfig),
+ *the SIP-flow and the RTP-statistics are printed to stdout.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+
+#include "sipmachine.h"
+#include "sipcallload.h"
+#include "rtpengine.h"
+#include "rtpreceiver.h"
+
+struct HeadlessConfig {
+    //SIP, without user no registration and no call
+    QString user;
+    QString password;
+    QString proxy;
+    QString call_destination;
+    CallSetup setup;
+    bool sip_log = false;
+    QString header_rules;
+    int sip_workers = 1;        //PJSIP worker-threads
+    int sip_handlers = 0;       //handler-threads for call/registration events, 0 = main-thread
+    int sip_log_level = 5;
+    SipTransportConfig transport;
+    SipMediaConfig media{SipMediaConfig::Null};    //no sound-device on a headless host
+    bool call_rtp = false;      //the RTP-stream starts with the negotiated media of the call, PJSIP does not send
+
+    //Call-load, with an account-file the calls are placed over its accounts
+    QString load_accounts;
+    CallLoadConfig call_load;
+
+    //RTP, a stream-list wins over the single stream
+    bool rtp = true;
+    RtpStreamConfig stream;
+    QString stream_list;
+    int workers = 0;
+    QString scenario;
+    QString audio;
+    int rtcp_interval_ms = 5000;    //for every stream, 0 = no RTCP
+
+    //DTMF, fired on every stream with a telephone-event payload-type
+    RtpDtmfSequence dtmf;           //no digits = no DTMF
+    int dtmf_at_ms = 1000;          //after the RTP-start
+    int dtmf_interval_ms = 0;       //0 = once
+
+    //RTP-receiver, analyses everything arriving on its port-range
+    bool rtp_receive = false;
+    RtpReceiverConfig receive;
+
+    int duration_s = 0;     //0 = until SIGINT/SIGTERM
+
+    bool load(const QString& path);
+    static bool parse_transport_type(const QString& name, SipTransportConfig::Type& type);
+};
+
+class HeadlessRunner : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(QObject* parent = nullptr);
+    ~HeadlessRunner();
+
+    bool start(const HeadlessConfig& config);
+
+public slots:
+    void stop();
+
+private slots:
+    void on_registration_state_changed(int sip_code, const QString& text);
+    void on_sip_message(const SipMessageInfo& info, const QByteArray& message);
+    void on_rtp_stream_stats(const QVector<RtpStreamStats>& stats);
+    void on_call_load_metrics(const CallLoadMetrics& metrics);
+    void on_rtp_receive_stats(const QVector<RtpReceiveStats>& stats);
+    void on_call_media_ready(const SipCallMedia& media);
+    void on_call_media_ended(int call_id);
+    void on_dtmf_timer();
+
+private:
+    //With call-media the single stream is sent to the negotiated media of the call
+    bool start_rtp(const SipCallMedia& media = SipCallMedia());
+
+    HeadlessConfig m_config;
+    SipMachine* m_sip = nullptr;
+    SipCallLoad* m_call_load = nullptr;
+    RtpEngine* m_rtp_engine;
+    RtpReceiver* m_rtp_receiver;
+    QTimer m_signal_timer;
+    QTimer m_dtmf_timer;
+    QTextStream m_out;
+    QHash<quint32, RtpStreamStats> m_rtp_stats;
+    QElapsedTimer m_stats_timer;
+    QHash<quint64, RtpReceiveStats> m_receive_stats;
+    QElapsedTimer m_receive_timer;
+    bool m_call_started = false;
+};
+
+#endif // HEADLESSRUNNER_H
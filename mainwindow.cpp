@@ -21,7 +21,7 @@
  *
  *Purpose of the file mainwindow.h/cpp:
  *In this file is the main work done with the ui and application-setup.
- *Some mandatory objects like SipMachine, FlowChart and UdpSocket are created
+ *Some mandatory objects like SipMachine, FlowChart and RtpEngine are created
  *here and added as member-objects to be available over the whole program.
  *It also connects the ui-buttons to the business-logic and is responsible
  *for activating/deactivating the config-options in the ui depending on
@@ -45,10 +45,16 @@
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
 
+#include <QAction>
 #include <QButtonGroup>
 #include <QDebug>
-#include <QtEndian>
-#include <QTimer>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QMenu>
+#include <QThread>
+
+//Telephone-event payload-type of streams without call, if the call-setup has no custom one
+const int default_event_payload_type = 101;
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -57,16 +63,38 @@ MainWindow::MainWindow(QWidget *parent)
     ui->setupUi(this);
     m_sip = new SipMachine(this);
     m_chart_widget = ui->gvFlowChart;
-    m_udp_socket = new QUdpSocket(this);
+    m_rtp_engine = new RtpEngine(this);
+    m_rtp_receiver = new RtpReceiver(this);
 
     connect(m_sip, &SipMachine::registration_state_changed, this, &MainWindow::on_registration_state_changed);
-    connect(m_sip, &SipMachine::new_sip_message, this, &MainWindow::display_sip_message, Qt::QueuedConnection);
+    connect(m_sip, &SipMachine::new_sip_message, this, &MainWindow::display_sip_message);
+    connect(m_sip, &SipMachine::sip_log_dropped, this, &MainWindow::on_sip_log_dropped);
+    connect(m_sip, &SipMachine::call_media_ready, this, &MainWindow::on_call_media_ready);
+    connect(m_sip, &SipMachine::call_media_ended, this, &MainWindow::on_call_media_ended);
+    connect(m_rtp_engine, &RtpEngine::stream_stats, this, &MainWindow::on_rtp_stream_stats, Qt::QueuedConnection);
+    connect(m_rtp_engine, &RtpEngine::stopped, this, &MainWindow::on_rtp_engine_stopped);
+    connect(m_rtp_receiver, &RtpReceiver::receive_stats, this, &MainWindow::on_rtp_receive_stats, Qt::QueuedConnection);
     connect(ui->rbAdvCallflow, &QRadioButton::toggled, this, &MainWindow::activate_advanced_call_setup);
     connect(ui->rbAdvRtpFlow, &QRadioButton::toggled, this, &MainWindow::activate_advanced_rtp_setup);
     connect(ui->rbCustCodecs, &QRadioButton::toggled, this, &MainWindow::activate_cust_codecs);
     connect(ui->rbInvokeGatekeeper, &QRadioButton::toggled, this, &MainWindow::activate_gatekeeper);
     connect(ui->rbAdvRegister, &QRadioButton::toggled, this, &MainWindow::activate_advanced_register_setup);
 
+    QMenu* rtp_menu = ui->menubar->addMenu("RTP");
+    rtp_menu->addAction("Start stream-list...", this, &MainWindow::on_load_stream_list);
+    rtp_menu->addAction("Load scenario...", this, &MainWindow::on_load_rtp_scenario);
+    rtp_menu->addAction("Load audio file...", this, &MainWindow::on_load_rtp_audio);
+    rtp_menu->addAction("Start/stop receiver...", this, &MainWindow::on_toggle_rtp_receiver);
+    rtp_menu->addAction("Send DTMF...", this, &MainWindow::on_send_dtmf);
+
+    QMenu* sip_menu = ui->menubar->addMenu("SIP");
+    sip_menu->addAction("Filter dialog...", this, &MainWindow::on_filter_sip_dialog);
+    sip_menu->addAction("Load header rules...", this, &MainWindow::on_load_sip_header_rules);
+    sip_menu->addAction("Log level...", this, &MainWindow::on_set_sip_log_level);
+    QAction* custom_rtp = sip_menu->addAction("Custom RTP on calls");
+    custom_rtp->setCheckable(true);
+    connect(custom_rtp, &QAction::toggled, this, &MainWindow::on_toggle_custom_rtp);
+
     //Disable Advanced-Options:
     MainWindow::activate_advanced_settings(false);
 
@@ -150,8 +178,12 @@ void MainWindow::on_registration_state_changed(int sip_code, const QString& text
     }
 }
 
-void MainWindow::display_sip_message(const QString& message) {
-    m_chart_widget->add_message(message);
+void MainWindow::display_sip_message(const SipMessageInfo& info, const QByteArray& message) {
+    m_chart_widget->add_message(info, message);
+}
+
+void MainWindow::on_sip_log_dropped(quint64 dropped) {
+    ui->statusbar->showMessage(QString("SIP log overflow: %1 messages dropped").arg(dropped));
 }
 
 void MainWindow::on_btnCall_clicked() {
@@ -195,6 +227,67 @@ CallSetup MainWindow::collect_ui_call_information() const {
     return setup;
 }
 
+std::shared_ptr<const RtpScenario> MainWindow::collect_ui_rtp_scenario() const {
+    //A loaded scenario-file wins over the ui-settings
+    if (m_file_scenario) {
+        return m_file_scenario;
+    }
+    if (!ui->rbAdvRtpFlow->isChecked()) {
+        return nullptr;
+    }
+
+    auto read_trigger = [](const QLineEdit* value, const QComboBox* unit) {
+        RtpTrigger trigger;
+        trigger.value = value->text().toDouble();
+        trigger.in_pakets = unit->currentText() == "pakets";
+        return trigger;
+    };
+
+    std::shared_ptr<RtpScenario> scenario = std::make_shared<RtpScenario>();
+    if (ui->cbSetStartSSRC->isChecked()) {
+        scenario->start_ssrc = ui->leSetStartSSRC->text();
+    }
+    if (ui->cbStartSequence->isChecked()) {
+        scenario->start_sequence = ui->leStartSequence->text().toInt();
+    }
+
+    if (ui->cbChangeSequence->isChecked()) {
+        RtpScenarioAction action;
+        action.type = RtpScenarioAction::ChangeSequence;
+        action.at = read_trigger(ui->leChangeSequence, ui->combChangeSequence);
+        action.also_ssrc = ui->cbChangeSequenceSSRC->isChecked();
+        if (ui->cbSetSequenceGap->isChecked()) {
+            action.sequence_gap = ui->leSetSequenceGap->text().toInt();
+        }
+        scenario->actions.push_back(action);
+    }
+
+    if (ui->cbChangeSSRC->isChecked()) {
+        RtpScenarioAction action;
+        action.type = RtpScenarioAction::ChangeSsrc;
+        action.at = read_trigger(ui->leChangeSSRC, ui->combChangeSSRC);
+        action.also_sequence = ui->cbChangeSSRCSequence->isChecked();
+        scenario->actions.push_back(action);
+    }
+
+    if (ui->cbStopRTP->isChecked() && ui->cbStopRTPafter->isChecked()) {
+        RtpScenarioAction action;
+        action.at = read_trigger(ui->leStopRTPafter, ui->combStopRTPafter);
+        if (ui->rbStopRTPfor->isChecked()) {
+            action.type = RtpScenarioAction::Pause;
+            action.duration = read_trigger(ui->leStopRTPfor, ui->combStopRTPfor);
+        } else {
+            action.type = RtpScenarioAction::Stop;
+        }
+        scenario->actions.push_back(action);
+    }
+
+    if (scenario->is_empty()) {
+        return nullptr;
+    }
+    return scenario;
+}
+
 void MainWindow::activate_advanced_rtp_setup(bool active) {
     ui->rbStopRTPcomplete->setEnabled(active);
     ui->rbStopRTPfor->setEnabled(active);
@@ -254,80 +347,313 @@ void MainWindow::activate_advanced_register_setup(bool active) {
 }
 
 void MainWindow::on_btnRtpPaket_clicked() {
-    int count = 0;
-    QTimer* timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, [=, &count]() mutable {
-        if (count >= 10) {
-            timer->stop();
+    if (m_rtp_engine->is_running()) {
+        m_rtp_engine->stop();
+        return;
+    }
+
+    //With an active call the stream goes to the negotiated media of the call
+    RtpStreamConfig config = MainWindow::collect_ui_rtp_stream();
+    bool call_rtp = m_call_media.call_id >= 0 && m_call_media.stream_config(config);
+
+    m_rtp_stats.clear();
+    if (m_rtp_engine->start(config)) {
+        m_call_rtp = call_rtp;
+        ui->btnRtpPaket->setText("Stop RTP");
+    }
+}
+
+RtpStreamConfig MainWindow::collect_ui_rtp_stream() const {
+    RtpStreamConfig config;
+    config.payload_type = "PCMA";
+    config.destination = QHostAddress("127.0.0.1");
+    config.port = 4000;
+    config.scenario = MainWindow::collect_ui_rtp_scenario();
+    config.audio = m_audio_asset;
+
+    //Without a call the telephone-event payload-type of the call-setup is used
+    CallSetup setup = MainWindow::collect_ui_call_information();
+    bool ok = false;
+    int event_payload_type = setup.cust_tel_pt.toInt(&ok);
+    config.event_payload_type = setup.cust_televent && ok ? event_payload_type : default_event_payload_type;
+    return config;
+}
+
+void MainWindow::on_send_dtmf() {
+    if (!m_rtp_engine->is_running()) {
+        ui->statusbar->showMessage("Start RTP first, DTMF is sent inside the RTP-streams");
+        return;
+    }
+
+    bool ok = false;
+    QString text = QInputDialog::getText(this, "Send DTMF", "Digits;duration ms;pause ms;volume -dBm0:",
+                                         QLineEdit::Normal, m_dtmf_input, &ok);
+    if (!ok || text.trimmed().isEmpty()) {
+        return;
+    }
+    m_dtmf_input = text;
+
+    QStringList fields = text.split(';');
+    RtpDtmfSequence sequence;
+    sequence.digits = fields[0].trimmed();
+    if (fields.size() > 1) sequence.duration_ms = fields[1].trimmed().toInt();
+    if (fields.size() > 2) sequence.pause_ms = fields[2].trimmed().toInt();
+    if (fields.size() > 3) sequence.volume = fields[3].trimmed().toInt();
+    if (m_rtp_engine->send_dtmf(sequence)) {
+        ui->statusbar->showMessage(QString("DTMF %1 fired").arg(sequence.digits));
+    } else {
+        ui->statusbar->showMessage("Invalid DTMF-sequence");
+    }
+}
+
+void MainWindow::on_toggle_custom_rtp(bool enabled) {
+    //Applies to the next call, PJSIP's stream of a running call is not touched
+    m_sip->set_custom_rtp(enabled);
+    ui->statusbar->showMessage(m_sip->custom_rtp() ? "Next calls are sent by the RTP-Engine" : "Next calls are sent by PJSIP");
+}
+
+void MainWindow::on_call_media_ready(const SipCallMedia& media) {
+    m_call_media = media;
+    ui->statusbar->showMessage(QString("Call media: %1 pt %2 to %3:%4, ptime %5 ms")
+                                   .arg(media.codec).arg(media.payload_type)
+                                   .arg(media.remote_address.toString()).arg(media.remote_port)
+                                   .arg(media.ptime_ms));
+    if (!m_sip->custom_rtp()) {
+        return;
+    }
+
+    //PJSIP does not send, so the engine follows every (re-)negotiation of the call
+    if (m_rtp_engine->is_running()) {
+        if (!m_call_rtp) {
             return;
         }
+        m_rtp_engine->stop();
+    }
+    RtpStreamConfig config = MainWindow::collect_ui_rtp_stream();
+    if (!media.stream_config(config)) {
+        return;
+    }
+    m_rtp_stats.clear();
+    if (m_rtp_engine->start(config)) {
+        m_call_rtp = true;
+        ui->btnRtpPaket->setText("Stop RTP");
+    }
+}
 
-        QByteArray paket = MainWindow::create_rtp_paket("PCMA", "0x11111111", count);
-        m_udp_socket->writeDatagram(paket, QHostAddress("127.0.0.1"), 4000);
-        count++;
-    });
-
-    timer->start(20);
-}
-
-QByteArray MainWindow::create_rtp_paket(const QString& payload_type, const QString& input_ssrc, uint16_t sequence) {
-    //Initial values
-    uint8_t pt = 0;
-    uint32_t timestamp_step = 0;
-    int payload_size = 0;
-
-    if (payload_type.toUpper() == "PCMU") {
-        pt = 0;
-        timestamp_step = 160;
-        payload_size = 160;
-    } else if (payload_type.toUpper() == "PCMA") {
-        pt = 8;
-        timestamp_step = 160;
-        payload_size = 160;
-    } else if (payload_type.toUpper() == "G722") {
-        pt = 9;
-        timestamp_step = 160;
-        payload_size = 160;
-    } else {
-        qWarning() << "Unsupported payload type: " << payload_type;
-        return QByteArray();
+void MainWindow::on_call_media_ended(int call_id) {
+    if (call_id != m_call_media.call_id) {
+        return;
+    }
+    m_call_media = SipCallMedia();
+    if (m_call_rtp && m_rtp_engine->is_running()) {
+        m_rtp_engine->stop();
+    }
+    m_call_rtp = false;
+}
+
+void MainWindow::on_load_stream_list() {
+    if (m_rtp_engine->is_running()) {
+        qWarning() << "RTP-Engine already running";
+        return;
     }
 
-#pragma pack(push, 1)
-    struct RtpHeader {
-        uint8_t v_p_x_cc;
-        uint8_t m_pt;
-        uint16_t seq;
-        uint32_t timestamp;
-        uint32_t ssrc;
-    };
-#pragma pack(pop)
+    QString path = QFileDialog::getOpenFileName(this, "Load RTP stream-list", QString(), "Stream-lists (*.csv *.txt);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QVector<RtpStreamConfig> streams;
+    if (!RtpEngine::load_stream_list(path, streams)) {
+        ui->statusbar->showMessage("Failed to load stream-list " + path);
+        return;
+    }
+
+    bool ok = false;
+    int workers = QInputDialog::getInt(this, "RTP load-mode", QString("%1 streams loaded, worker-threads:").arg(streams.size()),
+                                       QThread::idealThreadCount(), 1, 256, 1, &ok);
+    if (!ok) {
+        return;
+    }
+
+    std::shared_ptr<const RtpScenario> scenario = MainWindow::collect_ui_rtp_scenario();
+    for (RtpStreamConfig& config : streams) {
+        config.scenario = scenario;
+        config.audio = m_audio_asset;
+    }
+
+    m_rtp_stats.clear();
+    if (m_rtp_engine->start(streams, workers)) {
+        ui->btnRtpPaket->setText("Stop RTP");
+    }
+}
+
+void MainWindow::on_rtp_stream_stats(const QVector<RtpStreamStats>& stats) {
+    for (const RtpStreamStats& stream : stats) {
+        m_rtp_stats.insert(stream.stream_id, stream);
+    }
+
+    quint64 packets = 0;
+    double max_lateness_us = 0.0;
+    double jitter_sum_us = 0.0;
+    quint32 resyncs = 0;
+    double max_rtt_ms = -1.0;
+    double max_remote_loss = 0.0;
+    quint64 dtmf_events = 0;
+    for (const RtpStreamStats& stream : std::as_const(m_rtp_stats)) {
+        packets += stream.packets_sent;
+        dtmf_events += stream.dtmf_events;
+        max_lateness_us = qMax(max_lateness_us, stream.max_lateness_us);
+        jitter_sum_us += stream.jitter_us;
+        resyncs += stream.resyncs;
+        max_rtt_ms = qMax(max_rtt_ms, stream.rtt_ms);
+        max_remote_loss = qMax(max_remote_loss, stream.remote_loss_percent);
+    }
+
+    RtpTransportStats transport = m_rtp_engine->transport_stats();
+    QString message = QString("%1 RTP-streams: %2 pakets, max lateness %3 us, avg jitter %4 us, resyncs %5, syscalls saved %6, dropped %7")
+        .arg(m_rtp_stats.size())
+        .arg(packets)
+        .arg(max_lateness_us, 0, 'f', 1)
+        .arg(jitter_sum_us / qMax(1, int(m_rtp_stats.size())), 0, 'f', 1)
+        .arg(resyncs)
+        .arg(transport.datagrams - qMin(transport.datagrams, transport.syscalls))
+        .arg(transport.dropped);
+    if (max_rtt_ms >= 0) {
+        message += QString(", max RTT %1 ms, max remote loss %2 %").arg(max_rtt_ms, 0, 'f', 1).arg(max_remote_loss, 0, 'f', 1);
+    }
+    if (dtmf_events > 0) {
+        message += QString(", DTMF-events %1").arg(dtmf_events);
+    }
+    ui->statusbar->showMessage(message);
+}
+
+void MainWindow::on_load_rtp_scenario() {
+    QString path = QFileDialog::getOpenFileName(this, "Load RTP scenario", QString(), "Scenarios (*.json);;All files (*)");
+    if (path.isEmpty()) {
+        m_file_scenario.reset();
+        ui->statusbar->showMessage("RTP scenario-file removed, using ui-settings");
+        return;
+    }
+
+    std::shared_ptr<RtpScenario> scenario = std::make_shared<RtpScenario>();
+    if (!RtpScenario::load(path, *scenario)) {
+        ui->statusbar->showMessage("Failed to load RTP scenario " + path);
+        return;
+    }
+    m_file_scenario = scenario;
+    ui->statusbar->showMessage(QString("RTP scenario loaded: %1 events").arg(scenario->actions.size()));
+}
 
-    RtpHeader header{};
-    header.v_p_x_cc = (2 << 6);
-    header.m_pt = pt & 0x7F;
-    header.seq = qToBigEndian(sequence);
+void MainWindow::on_load_rtp_audio() {
+    QString path = QFileDialog::getOpenFileName(this, "Load RTP audio", QString(), "Audio (*.wav *.raw *.pcm);;All files (*)");
+    if (path.isEmpty()) {
+        m_audio_asset.reset();
+        ui->statusbar->showMessage("RTP audio removed, using filler-payload");
+        return;
+    }
 
-    static uint32_t global_timestamp = 0;
-    header.timestamp = qToBigEndian(global_timestamp);
-    global_timestamp += timestamp_step;
+    std::shared_ptr<RtpAudioAsset> audio = std::make_shared<RtpAudioAsset>();
+    if (!audio->load(path)) {
+        ui->statusbar->showMessage("Failed to load RTP audio " + path);
+        return;
+    }
+    m_audio_asset = audio;
+    ui->statusbar->showMessage(QString("RTP audio loaded: %1 s").arg(audio->duration_s(), 0, 'f', 1));
+}
+
+void MainWindow::on_toggle_rtp_receiver() {
+    if (m_rtp_receiver->is_running()) {
+        m_rtp_receiver->stop();
+        ui->statusbar->showMessage("RTP-receiver stopped");
+        return;
+    }
 
     bool ok = false;
-    uint32_t ssrc = input_ssrc.toUInt(&ok, 0);
-    if (!ok) ssrc = 0x0000FFFF;
-    header.ssrc = qToBigEndian(ssrc);
+    int first_port = QInputDialog::getInt(this, "RTP receiver", "First port:", 4000, 1, 65535, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    int port_count = QInputDialog::getInt(this, "RTP receiver", "Number of ports:", 1, 1, 65536 - first_port, 1, &ok);
+    if (!ok) {
+        return;
+    }
+
+    RtpReceiverConfig config;
+    config.first_port = quint16(first_port);
+    config.port_count = port_count;
+    m_receive_stats.clear();
+    if (m_rtp_receiver->start(config)) {
+        ui->statusbar->showMessage(QString("RTP-receiver listening on %1 ports from %2").arg(port_count).arg(first_port));
+    }
+}
+
+void MainWindow::on_rtp_receive_stats(const QVector<RtpReceiveStats>& stats) {
+    for (const RtpReceiveStats& stream : stats) {
+        m_receive_stats.insert((quint64(stream.port) << 32) | stream.ssrc, stream);
+    }
 
-    QByteArray payload(payload_size, 0xFF);
-    if (payload_type.toUpper() == "G722") {
-        payload.fill(0x00);
+    quint64 packets = 0;
+    qint64 lost = 0;
+    quint64 reordered = 0;
+    quint64 duplicates = 0;
+    double max_jitter_ms = 0.0;
+    for (const RtpReceiveStats& stream : std::as_const(m_receive_stats)) {
+        packets += stream.packets;
+        lost += stream.lost;
+        reordered += stream.reordered;
+        duplicates += stream.duplicates;
+        max_jitter_ms = qMax(max_jitter_ms, stream.jitter_ms);
     }
 
+    ui->statusbar->showMessage(QString("%1 received RTP-streams: %2 pakets, lost %3, max jitter %4 ms, reordered %5, duplicates %6")
+        .arg(m_receive_stats.size())
+        .arg(packets)
+        .arg(lost)
+        .arg(max_jitter_ms, 0, 'f', 2)
+        .arg(reordered)
+        .arg(duplicates));
+}
 
-    QByteArray packet;
-    packet.resize(sizeof(RtpHeader) + payload_size);
-    memcpy(packet.data(), &header, sizeof(RtpHeader));
-    memcpy(packet.data() + sizeof(RtpHeader), payload.constData(), payload_size);
+void MainWindow::on_filter_sip_dialog() {
+    bool ok = false;
+    QString call_id = QInputDialog::getText(this, "Filter SIP dialog", "Call-ID (empty = show all):", QLineEdit::Normal, QString(), &ok);
+    if (!ok) {
+        return;
+    }
 
-    return packet;
+    int shown = m_chart_widget->set_dialog_filter(call_id.trimmed().toUtf8());
+    ui->statusbar->showMessage(QString("%1 SIP-messages shown, %2 dialogs captured").arg(shown).arg(m_chart_widget->index().dialog_count()));
 }
 
+void MainWindow::on_load_sip_header_rules() {
+    QString path = QFileDialog::getOpenFileName(this, "Load SIP header rules", QString(), "Header rules (*.json);;All files (*)");
+    if (path.isEmpty()) {
+        m_sip->set_header_rules(SipHeaderRules());
+        ui->statusbar->showMessage("SIP header rules removed");
+        return;
+    }
+
+    SipHeaderRules rules;
+    if (!SipHeaderRules::load(path, rules)) {
+        ui->statusbar->showMessage("Failed to load SIP header rules " + path);
+        return;
+    }
+    m_sip->set_header_rules(rules);
+    ui->statusbar->showMessage(QString("SIP header rules loaded: %1 rules").arg(rules.rules.size()));
+}
+
+void MainWindow::on_set_sip_log_level() {
+    bool ok = false;
+    int level = QInputDialog::getInt(this, "SIP log level", "PJSIP log-level (below 4 no SIP-messages are shown):",
+                                     m_sip->log_level(), 0, 6, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    m_sip->set_log_level(level);
+    ui->statusbar->showMessage(QString("PJSIP log-level %1").arg(level));
+}
+
+void MainWindow::on_rtp_engine_stopped() {
+    m_call_rtp = false;
+    ui->btnRtpPaket->setText("RTP-Paket");
+}
@@ -21,7 +21,7 @@
  *
  *Purpose of the file mainwindow.h/cpp:
  *In this file is the main work done with the ui and application-setup.
- *Some mandatory objects like SipMachine, FlowChart and UdpSocket are created
+ *Some mandatory objects like SipMachine, FlowChart and RtpEngine are created
  *here and added as member-objects to be available over the whole program.
  *It also connects the ui-buttons to the business-logic and is responsible
  *for activating/deactivating the config-options in the ui depending on
@@ -46,9 +46,11 @@
 
 #include "sipmachine.h"
 #include "flowchart.h"
+#include "rtpengine.h"
+#include "rtpreceiver.h"
 
 #include <QMainWindow>
-#include <QUdpSocket>
+#include <QHash>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -67,11 +69,26 @@ public:
 private slots:
     void on_btnRegister_clicked();
     void on_registration_state_changed(int sip_code, const QString& text);
-    void display_sip_message(const QString& message);
+    void display_sip_message(const SipMessageInfo& info, const QByteArray& message);
+    void on_sip_log_dropped(quint64 dropped);
     void on_btnCall_clicked();
     void on_btnEndCall_clicked();
     void on_btnDeRegister_clicked();
     void on_btnRtpPaket_clicked();
+    void on_load_stream_list();
+    void on_load_rtp_scenario();
+    void on_load_rtp_audio();
+    void on_toggle_rtp_receiver();
+    void on_send_dtmf();
+    void on_filter_sip_dialog();
+    void on_load_sip_header_rules();
+    void on_set_sip_log_level();
+    void on_rtp_stream_stats(const QVector<RtpStreamStats>& stats);
+    void on_rtp_engine_stopped();
+    void on_rtp_receive_stats(const QVector<RtpReceiveStats>& stats);
+    void on_toggle_custom_rtp(bool enabled);
+    void on_call_media_ready(const SipCallMedia& media);
+    void on_call_media_ended(int call_id);
 
 
 private:
@@ -83,13 +100,22 @@ private:
     void activate_cust_codecs(bool active);
     void activate_gatekeeper(bool active);
 
-    QByteArray create_rtp_paket(const QString& payload_type, const QString& ssrc, uint16_t sequence);
     CallSetup collect_ui_call_information() const;
+    std::shared_ptr<const RtpScenario> collect_ui_rtp_scenario() const;
+    RtpStreamConfig collect_ui_rtp_stream() const;
 
     Ui::MainWindow* ui;
     SipMachine* m_sip;
     FlowChart* m_chart_widget;
-    QUdpSocket* m_udp_socket;
+    RtpEngine* m_rtp_engine;
+    QHash<quint32, RtpStreamStats> m_rtp_stats;
+    RtpReceiver* m_rtp_receiver;
+    QHash<quint64, RtpReceiveStats> m_receive_stats;
+    std::shared_ptr<const RtpScenario> m_file_scenario;
+    std::shared_ptr<const RtpAudioAsset> m_audio_asset;
+    SipCallMedia m_call_media;      //call_id -1 = no call with media
+    bool m_call_rtp = false;        //the running engine sends the media of the call
+    QString m_dtmf_input = "123#;100;100;10";
 
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtcppacket.h/cpp:
+ *The RtcpPacket-Class renders and parses the RTCP-pakets (RFC 3550 6.4)
+ *which accompany the generated RTP-streams. A compound paket of a stream
+ *is a sender report (or a receiver report while the stream is silent)
+ *followed by a SDES CNAME, at the end of a stream a BYE is appended.
+ *Incoming SR/RR are walked without copying, every report block is handed
+ *out together with the round-trip time computed from LSR/DLSR.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtcppacket.h"
+
+#include <cstring>
+
+//Seconds between 1900-01-01 (NTP-era) and 1970-01-01 (unix-epoch)
+const uint64_t ntp_unix_offset_s = 2208988800ULL;
+
+static inline void write_u16(uint8_t* out, uint16_t value) {
+    out[0] = uint8_t(value >> 8);
+    out[1] = uint8_t(value);
+}
+
+static inline void write_u32(uint8_t* out, uint32_t value) {
+    out[0] = uint8_t(value >> 24);
+    out[1] = uint8_t(value >> 16);
+    out[2] = uint8_t(value >> 8);
+    out[3] = uint8_t(value);
+}
+
+static inline uint32_t read_u32(const uint8_t* in) {
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | in[3];
+}
+
+//Common header: V=2, P=0, count, type, length in 32-bit words minus one
+static inline void write_header(uint8_t* out, int count, uint8_t type, int size) {
+    out[0] = uint8_t(0x80 | count);
+    out[1] = type;
+    write_u16(out + 2, uint16_t(size / 4 - 1));
+}
+
+uint64_t RtcpPacket::ntp_timestamp(int64_t unix_ns) {
+    uint64_t seconds = uint64_t(unix_ns / 1000000000LL) + ntp_unix_offset_s;
+    uint64_t fraction = (uint64_t(unix_ns % 1000000000LL) << 32) / 1000000000ULL;
+    return (seconds << 32) | fraction;
+}
+
+int RtcpPacket::write_sender_report(uint8_t* out, uint32_t ssrc, uint64_t ntp, uint32_t rtp_timestamp, uint32_t packets, uint32_t octets) {
+    write_header(out, 0, type_sr, 28);
+    write_u32(out + 4, ssrc);
+    write_u32(out + 8, uint32_t(ntp >> 32));
+    write_u32(out + 12, uint32_t(ntp));
+    write_u32(out + 16, rtp_timestamp);
+    write_u32(out + 20, packets);
+    write_u32(out + 24, octets);
+    return 28;
+}
+
+int RtcpPacket::write_receiver_report(uint8_t* out, uint32_t ssrc) {
+    write_header(out, 0, type_rr, 8);
+    write_u32(out + 4, ssrc);
+    return 8;
+}
+
+int RtcpPacket::write_sdes_cname(uint8_t* out, uint32_t ssrc, const QByteArray& cname) {
+    int length = qMin(int(cname.size()), 255);
+    //SSRC + item (type, length, text) + at least one null-octet, padded to 32 bits
+    int size = (4 + 4 + 2 + length + 1 + 3) & ~3;
+    memset(out, 0, size_t(size));
+    write_header(out, 1, type_sdes, size);
+    write_u32(out + 4, ssrc);
+    out[8] = 1;     //CNAME
+    out[9] = uint8_t(length);
+    memcpy(out + 10, cname.constData(), size_t(length));
+    return size;
+}
+
+int RtcpPacket::write_bye(uint8_t* out, uint32_t ssrc) {
+    write_header(out, 1, type_bye, 8);
+    write_u32(out + 4, ssrc);
+    return 8;
+}
+
+int RtcpPacket::parse_report_blocks(const uint8_t* data, int size, RtcpReportBlock* blocks, int max_blocks) {
+    //RFC 3550 A.2: the first paket of a compound is a SR or RR without padding
+    if (size < 8 || (data[0] & 0xE0) != 0x80 || (data[1] != type_sr && data[1] != type_rr)) {
+        return -1;
+    }
+
+    int found = 0;
+    int offset = 0;
+    while (offset + 4 <= size) {
+        const uint8_t* paket = data + offset;
+        int length = (((paket[2] << 8) | paket[3]) + 1) * 4;
+        if ((paket[0] >> 6) != 2 || offset + length > size) {
+            return -1;
+        }
+
+        int count = paket[0] & 0x1F;
+        int first_block = paket[1] == type_sr ? 28 : (paket[1] == type_rr ? 8 : -1);
+        if (first_block > 0 && first_block + count * 24 <= length) {
+            for (int i = 0; i < count && found < max_blocks; ++i) {
+                const uint8_t* in = paket + first_block + i * 24;
+                RtcpReportBlock& block = blocks[found++];
+                block.ssrc = read_u32(in);
+                block.fraction_lost = in[4];
+                //24 bit two's complement
+                int32_t lost = int32_t((uint32_t(in[5]) << 16) | (uint32_t(in[6]) << 8) | in[7]);
+                block.cumulative_lost = (lost & 0x800000) ? lost - 0x1000000 : lost;
+                block.highest_sequence = read_u32(in + 8);
+                block.jitter = read_u32(in + 12);
+                block.last_sr = read_u32(in + 16);
+                block.delay_since_last_sr = read_u32(in + 20);
+            }
+        }
+        offset += length;
+    }
+    return found;
+}
+
+double RtcpPacket::round_trip_ms(uint32_t arrival_ntp_middle, const RtcpReportBlock& block) {
+    if (block.last_sr == 0) {
+        return -1.0;
+    }
+    //Modulo 2^32 in units of 1/65536 s, a negative result is a clock-step or a bogus report
+    int32_t rtt = int32_t(arrival_ntp_middle - block.last_sr - block.delay_since_last_sr);
+    if (rtt < 0) {
+        return -1.0;
+    }
+    return double(rtt) * 1000.0 / 65536.0;
+}
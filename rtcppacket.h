@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtcppacket.h/cpp:
+ *The RtcpPacket-Class renders and parses the RTCP-pakets (RFC 3550 6.4)
+ *which accompany the generated RTP-streams. A compound paket of a stream
+ *is a sender report (or a receiver report while the stream is silent)
+ *followed by a SDES CNAME, at the end of a stream a BYE is appended.
+ *Incoming SR/RR are walked without copying, every report block is handed
+ *out together with the round-trip time computed from LSR/DLSR.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTCPPACKET_H
+#define RTCPPACKET_H
+
+#include <QByteArray>
+
+#include <cstdint>
+
+struct RtcpReportBlock {
+    uint32_t ssrc = 0;              //source the block reports about
+    uint8_t fraction_lost = 0;      //fixed point, /256
+    int32_t cumulative_lost = 0;
+    uint32_t highest_sequence = 0;
+    uint32_t jitter = 0;            //in timestamp-units
+    uint32_t last_sr = 0;           //middle 32 bits of the NTP-timestamp of our last SR
+    uint32_t delay_since_last_sr = 0;   //1/65536 s
+};
+
+class RtcpPacket {
+
+public:
+    //SR with sender info, no report blocks + SDES with a CNAME up to 255 bytes + BYE
+    static const int max_compound_size = 28 + 8 + 2 + 255 + 3 + 8;
+
+    static const uint8_t type_sr = 200;
+    static const uint8_t type_rr = 201;
+    static const uint8_t type_sdes = 202;
+    static const uint8_t type_bye = 203;
+
+    static uint64_t ntp_timestamp(int64_t unix_ns);
+    static uint32_t ntp_middle(uint64_t ntp) { return uint32_t(ntp >> 16); }
+
+    //All writers return the written size in bytes, the buffer has to hold max_compound_size
+    static int write_sender_report(uint8_t* out, uint32_t ssrc, uint64_t ntp, uint32_t rtp_timestamp, uint32_t packets, uint32_t octets);
+    static int write_receiver_report(uint8_t* out, uint32_t ssrc);
+    static int write_sdes_cname(uint8_t* out, uint32_t ssrc, const QByteArray& cname);
+    static int write_bye(uint8_t* out, uint32_t ssrc);
+
+    //Walks a compound paket and returns the report blocks of all SR/RR in it,
+    //-1 if the paket is no valid RTCP. Blocks beyond max_blocks are skipped.
+    static int parse_report_blocks(const uint8_t* data, int size, RtcpReportBlock* blocks, int max_blocks);
+
+    //RFC 3550 6.4.1: A - LSR - DLSR, -1 if the block does not refer to a SR of ours
+    static double round_trip_ms(uint32_t arrival_ntp_middle, const RtcpReportBlock& block);
+};
+
+#endif // RTCPPACKET_H
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpaudioasset.h/cpp:
+ *The RtpAudioAsset-Class loads a WAV- or raw PCM-file through a memory
+ *mapping and encodes it once into PCMU, PCMA and G722. The encoded
+ *frames are kept in one table per codec which many RtpStreams can share,
+ *the pakets only reference the frames, nothing is copied or encoded
+ *while sending.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "rtpaudioasset.h"
+#include "g711.h"
+#include "g722encoder.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+
+bool RtpAudioAsset::load(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Can't open audio file: " << path;
+        return false;
+    }
+
+    //The file is only mapped while it gets encoded, afterwards the frame tables are used
+    qint64 size = file.size();
+    const uint8_t* data = size > 0 ? file.map(0, size) : nullptr;
+    if (!data) {
+        qWarning() << "Can't map audio file: " << path;
+        return false;
+    }
+
+    std::vector<int16_t> pcm;
+    int sample_rate = 8000;
+    QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == "raw" || suffix == "pcm") {
+        pcm.resize(size_t(size / 2));
+        for (size_t i = 0; i < pcm.size(); ++i) {
+            pcm[i] = qFromLittleEndian<qint16>(data + i * 2);
+        }
+    } else if (!RtpAudioAsset::parse_wav(data, size, pcm, sample_rate)) {
+        qWarning() << "Unsupported WAV file: " << path;
+        file.unmap(const_cast<uint8_t*>(data));
+        return false;
+    }
+    file.unmap(const_cast<uint8_t*>(data));
+
+    std::vector<int16_t> pcm8k = RtpAudioAsset::resample(pcm, sample_rate, 8000);
+    std::vector<int16_t> pcm16k = RtpAudioAsset::resample(pcm, sample_rate, 16000);
+    if (pcm8k.empty()) {
+        qWarning() << "Audio file contains no samples: " << path;
+        return false;
+    }
+    //G722 encodes two 16kHz samples into one byte, so both tables get the same length
+    pcm16k.resize(pcm8k.size() * 2, 0);
+
+    m_pcmu.resize(pcm8k.size());
+    m_pcma.resize(pcm8k.size());
+    m_g722.resize(pcm8k.size());
+    G711::encode_ulaw(pcm8k.data(), pcm8k.size(), m_pcmu.data());
+    G711::encode_alaw(pcm8k.data(), pcm8k.size(), m_pcma.data());
+    G722Encoder encoder;
+    encoder.encode(pcm16k.data(), pcm16k.size(), m_g722.data());
+
+    m_path = path;
+    qDebug() << "Audio file loaded: " << path << duration_s() << "s";
+    return true;
+}
+
+const std::vector<uint8_t>* RtpAudioAsset::frames(uint8_t payload_type) const {
+    switch (payload_type) {
+    case 0:
+        return &m_pcmu;
+    case 8:
+        return &m_pcma;
+    case 9:
+        return &m_g722;
+    default:
+        return nullptr;
+    }
+}
+
+bool RtpAudioAsset::parse_wav(const uint8_t* data, qint64 size, std::vector<int16_t>& pcm, int& sample_rate) {
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    int format = 0;
+    int channels = 0;
+    int bits = 0;
+    const uint8_t* samples = nullptr;
+    qint64 samples_size = 0;
+
+    qint64 pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = data + pos;
+        qint64 chunk_size = qFromLittleEndian<quint32>(chunk + 4);
+        qint64 available = qMin(chunk_size, size - pos - 8);
+        if (memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = qFromLittleEndian<quint16>(chunk + 8);
+            channels = qFromLittleEndian<quint16>(chunk + 10);
+            sample_rate = int(qFromLittleEndian<quint32>(chunk + 12));
+            bits = qFromLittleEndian<quint16>(chunk + 22);
+            if (format == 0xFFFE && available >= 26) {
+                //WAVE_FORMAT_EXTENSIBLE: the real format is in the first two byte of the sub-format GUID
+                format = qFromLittleEndian<quint16>(chunk + 32);
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            samples = chunk + 8;
+            samples_size = available;
+        }
+        //Chunks are padded to an even size
+        pos += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    if (!samples || channels < 1 || sample_rate <= 0) {
+        return false;
+    }
+
+    //1 = PCM, 6 = A-law, 7 = u-law
+    int sample_bytes;
+    if (format == 1 && bits == 16) {
+        sample_bytes = 2;
+    } else if ((format == 6 || format == 7) && bits == 8) {
+        sample_bytes = 1;
+    } else {
+        return false;
+    }
+
+    //Multi channel files are mixed down to mono
+    size_t frame_bytes = size_t(sample_bytes) * size_t(channels);
+    size_t frame_count = size_t(samples_size) / frame_bytes;
+    pcm.resize(frame_count);
+    for (size_t i = 0; i < frame_count; ++i) {
+        const uint8_t* frame = samples + i * frame_bytes;
+        int sum = 0;
+        for (int c = 0; c < channels; ++c) {
+            if (format == 1) {
+                sum += qFromLittleEndian<qint16>(frame + c * 2);
+            } else if (format == 6) {
+                sum += G711::alaw_to_linear(frame[c]);
+            } else {
+                sum += G711::ulaw_to_linear(frame[c]);
+            }
+        }
+        pcm[i] = int16_t(sum / channels);
+    }
+    return true;
+}
+
+std::vector<int16_t> RtpAudioAsset::resample(const std::vector<int16_t>& pcm, int from_rate, int to_rate) {
+    if (from_rate == to_rate || pcm.empty()) {
+        return pcm;
+    }
+
+    //Plain linear interpolation, good enough for test-audio towards a transcoder
+    size_t out_size = size_t(uint64_t(pcm.size()) * uint64_t(to_rate) / uint64_t(from_rate));
+    std::vector<int16_t> out(out_size);
+    double step = double(from_rate) / double(to_rate);
+    for (size_t i = 0; i < out_size; ++i) {
+        double position = double(i) * step;
+        size_t index = size_t(position);
+        double fraction = position - double(index);
+        int a = pcm[index];
+        int b = index + 1 < pcm.size() ? pcm[index + 1] : a;
+        out[i] = int16_t(a + (b - a) * fraction);
+    }
+    return out;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpaudioasset.h/cpp:
+ *The RtpAudioAsset-Class loads a WAV- or raw PCM-file through a memory
+ *mapping and encodes it once into PCMU, PCMA and G722. The encoded
+ *frames are kept in one table per codec which many RtpStreams can share,
+ *the pakets only reference the frames, nothing is copied or encoded
+ *while sending.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPAUDIOASSET_H
+#define RTPAUDIOASSET_H
+
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RtpAudioAsset {
+
+public:
+    //Supported are WAV-files with 16 bit PCM, A-law or u-law (mono or stereo, any
+    //sample rate) and headerless .raw/.pcm files with 16 bit little endian 8kHz mono
+    bool load(const QString& path);
+
+    const QString& path() const { return m_path; }
+    double duration_s() const { return double(m_pcma.size()) / 8000.0; }
+
+    //Encoded payload for the RTP payload type (0, 8 or 9), 8 byte per ms.
+    //Returns nullptr if the payload type is unknown.
+    const std::vector<uint8_t>* frames(uint8_t payload_type) const;
+
+private:
+    static bool parse_wav(const uint8_t* data, qint64 size, std::vector<int16_t>& pcm, int& sample_rate);
+    static std::vector<int16_t> resample(const std::vector<int16_t>& pcm, int from_rate, int to_rate);
+
+    QString m_path;
+    std::vector<uint8_t> m_pcmu;
+    std::vector<uint8_t> m_pcma;
+    std::vector<uint8_t> m_g722;
+};
+
+#endif // RTPAUDIOASSET_H
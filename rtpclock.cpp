@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpclock.h/cpp:
+ *The RtpClock-Class wraps the monotonic clock of the operating system.
+ *All RTP-deadlines are calculated as absolute nanoseconds on this clock,
+ *so the sender never accumulates drift from relative sleeps (like QTimer).
+ *On Linux clock_gettime/clock_nanosleep(TIMER_ABSTIME) is used, on Windows
+ *a high-resolution waitable timer plus a short spin to the deadline, on
+ *other platforms std::chrono::steady_clock is the fallback.
+ *unix_ns() is the wallclock, only used where a timestamp leaves the host
+ *(NTP-timestamps of RTCP).
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpclock.h"
+
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+int64_t RtpClock::now_ns() {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int64_t RtpClock::unix_ns() {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void RtpClock::sleep_until(int64_t deadline_ns) {
+#ifdef __linux__
+    timespec ts;
+    ts.tv_sec = deadline_ns / 1000000000LL;
+    ts.tv_nsec = deadline_ns % 1000000000LL;
+    //Absolute sleep: a signal interrupting us just sleeps again to the same deadline
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#elif defined(_WIN32)
+    //sleep_until of the runtime follows the 15.6 ms system-tick. One high-resolution waitable
+    //timer per thread (Windows 10 1803+) sleeps to shortly before the deadline and the rest is
+    //spun on the clock. Older systems get a normal timer with a 1 ms tick for the process.
+    struct WaitTimer {
+        HANDLE handle = nullptr;
+        int64_t spin_ns = 0;
+
+        WaitTimer() {
+            handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+            spin_ns = 200000;
+            if (!handle) {
+                static const bool period_set = timeBeginPeriod(1) == TIMERR_NOERROR;
+                (void)period_set;
+                handle = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+                spin_ns = 1500000;
+            }
+        }
+        ~WaitTimer() {
+            if (handle) {
+                CloseHandle(handle);
+            }
+        }
+    };
+    static thread_local WaitTimer timer;
+
+    int64_t remaining = deadline_ns - RtpClock::now_ns() - timer.spin_ns;
+    if (remaining > 0 && timer.handle) {
+        //Negative = relative in 100 ns, the clock of now_ns() is not the one of the timer
+        LARGE_INTEGER due;
+        due.QuadPart = -(remaining / 100);
+        if (SetWaitableTimerEx(timer.handle, &due, 0, nullptr, nullptr, nullptr, 0)) {
+            WaitForSingleObject(timer.handle, INFINITE);
+        }
+    }
+    while (RtpClock::now_ns() < deadline_ns) {
+        YieldProcessor();
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(deadline_ns))));
+#endif
+}
+
+bool RtpClock::raise_thread_priority() {
+#ifdef __linux__
+    //SCHED_FIFO needs CAP_SYS_NICE, without it we silently keep the normal scheduler
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#else
+    return false;
+#endif
+}
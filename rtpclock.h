@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpclock.h/cpp:
+ *The RtpClock-Class wraps the monotonic clock of the operating system.
+ *All RTP-deadlines are calculated as absolute nanoseconds on this clock,
+ *so the sender never accumulates drift from relative sleeps (like QTimer).
+ *On Linux clock_gettime/clock_nanosleep(TIMER_ABSTIME) is used, on Windows
+ *a high-resolution waitable timer plus a short spin to the deadline, on
+ *other platforms std::chrono::steady_clock is the fallback.
+ *unix_ns() is the wallclock, only used where a timestamp leaves the host
+ *(NTP-timestamps of RTCP).
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPCLOCK_H
+#define RTPCLOCK_H
+
+#include <cstdint>
+
+class RtpClock {
+
+public:
+    static int64_t now_ns();
+    static int64_t unix_ns();
+    static void sleep_until(int64_t deadline_ns);
+    static bool raise_thread_priority();
+};
+
+#endif // RTPCLOCK_H
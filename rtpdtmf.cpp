@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpdtmf.h/cpp:
+ *The RtpDtmfSequence-Class describes out-of-band DTMF as RFC 4733
+ *telephone-events: a string of digits with duration, pause and volume.
+ *Like the RtpScenario it is compiled before it is fired - into the list of
+ *event-pakets per ptime-slot with the complete 4 byte payload (event,
+ *end-bit, volume, duration) already rendered. The compiled RtpDtmfPlan is
+ *immutable and shared by every stream it is fired on, the RtpStream only
+ *patches sequence-number and timestamp, so one plan can be fired on
+ *thousands of streams at once.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpdtmf.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+//The duration-field has 16 bit, longer events would need segments (RFC 4733 2.5.1.3)
+const int max_duration_samples = 0xFFFF;
+
+const std::vector<RtpDtmfPaket>* RtpDtmfPlan::pakets(int ptime_ms) const {
+    for (size_t i = 0; i < m_ptimes_ms.size(); ++i) {
+        if (m_ptimes_ms[i] == ptime_ms) {
+            return &m_pakets[i];
+        }
+    }
+    return nullptr;
+}
+
+bool RtpDtmfSequence::event_code(QChar digit, uint8_t& code) {
+    //RFC 4733 3.2: 0-9, * = 10, # = 11, A-D = 12-15
+    char c = digit.toUpper().toLatin1();
+    if (c >= '0' && c <= '9') {
+        code = uint8_t(c - '0');
+    } else if (c == '*') {
+        code = 10;
+    } else if (c == '#') {
+        code = 11;
+    } else if (c >= 'A' && c <= 'D') {
+        code = uint8_t(12 + c - 'A');
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool RtpDtmfSequence::is_valid() const {
+    if (digits.isEmpty()) {
+        qWarning() << "No DTMF-digits";
+        return false;
+    }
+    uint8_t code = 0;
+    for (QChar digit : digits) {
+        if (!RtpDtmfSequence::event_code(digit, code)) {
+            qWarning() << "Invalid DTMF-digit:" << digit;
+            return false;
+        }
+    }
+    if (duration_ms <= 0 || duration_ms * 8 > max_duration_samples) {
+        qWarning() << "Unsupported DTMF-duration:" << duration_ms;
+        return false;
+    }
+    if (pause_ms < 0 || volume < 0 || volume > 63) {
+        qWarning() << "Invalid DTMF-pause or volume:" << pause_ms << volume;
+        return false;
+    }
+    return true;
+}
+
+std::vector<RtpDtmfPaket> RtpDtmfSequence::compile(int ptime_ms) const {
+    std::vector<RtpDtmfPaket> pakets;
+    if (ptime_ms <= 0) {
+        return pakets;
+    }
+
+    //8 kHz RTP-clock like the voice (RFC 4733 2.1), one event-paket replaces one voice-paket
+    const int step = ptime_ms * 8;
+    const int total = duration_ms * 8;
+    const uint64_t event_slots = uint64_t((total + step - 1) / step);
+    //The retransmitted end-pakets are part of the pause, the voice resumes after them
+    const uint64_t pause_slots = std::max<uint64_t>(end_pakets - 1, uint64_t((pause_ms + ptime_ms - 1) / ptime_ms));
+
+    uint64_t tick = 0;
+    for (QChar digit : digits) {
+        uint8_t code = 0;
+        if (!RtpDtmfSequence::event_code(digit, code)) {
+            continue;
+        }
+        for (uint64_t i = 0; i < event_slots + end_pakets - 1; ++i) {
+            bool end = i + 1 >= event_slots;
+            int duration = end ? total : int(i + 1) * step;
+            RtpDtmfPaket paket;
+            paket.tick = tick + i;
+            paket.payload[0] = code;
+            paket.payload[1] = uint8_t((end ? 0x80 : 0x00) | (volume & 0x3F));
+            paket.payload[2] = uint8_t(duration >> 8);
+            paket.payload[3] = uint8_t(duration);
+            paket.marker = i == 0;
+            pakets.push_back(paket);
+        }
+        tick += event_slots + pause_slots;
+    }
+    return pakets;
+}
+
+std::shared_ptr<const RtpDtmfPlan> RtpDtmfSequence::compile_plan(const std::vector<int>& ptimes_ms) const {
+    if (!RtpDtmfSequence::is_valid()) {
+        return nullptr;
+    }
+    std::shared_ptr<RtpDtmfPlan> plan = std::make_shared<RtpDtmfPlan>();
+    for (int ptime_ms : ptimes_ms) {
+        if (plan->pakets(ptime_ms)) {
+            continue;
+        }
+        plan->m_ptimes_ms.push_back(ptime_ms);
+        plan->m_pakets.push_back(RtpDtmfSequence::compile(ptime_ms));
+    }
+    return plan;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpdtmf.h/cpp:
+ *The RtpDtmfSequence-Class describes out-of-band DTMF as RFC 4733
+ *telephone-events: a string of digits with duration, pause and volume.
+ *Like the RtpScenario it is compiled before it is fired - into the list of
+ *event-pakets per ptime-slot with the complete 4 byte payload (event,
+ *end-bit, volume, duration) already rendered. The compiled RtpDtmfPlan is
+ *immutable and shared by every stream it is fired on, the RtpStream only
+ *patches sequence-number and timestamp, so one plan can be fired on
+ *thousands of streams at once.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPDTMF_H
+#define RTPDTMF_H
+
+#include <QChar>
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct RtpDtmfPaket {
+    uint64_t tick;          //ptime-slot relative to the slot the sequence is fired in
+    uint8_t payload[4];     //RFC 4733 2.3: event, E/R/volume, duration
+    bool marker;            //first paket of an event, starts a new event-timestamp
+};
+
+//The compiled sequence for every ptime of the streams it is fired on
+class RtpDtmfPlan {
+
+public:
+    const std::vector<RtpDtmfPaket>* pakets(int ptime_ms) const;
+
+private:
+    friend class RtpDtmfSequence;
+
+    std::vector<int> m_ptimes_ms;
+    std::vector<std::vector<RtpDtmfPaket>> m_pakets;
+};
+
+class RtpDtmfSequence {
+
+public:
+    //RFC 4733 2.5.1.4: the final paket of an event is sent three times
+    static const int end_pakets = 3;
+    static const int payload_size = 4;
+
+    QString digits;         //0-9, *, #, A-D
+    int duration_ms = 100;
+    int pause_ms = 100;     //between two events, the voice is sent
+    int volume = 10;        //power level in -dBm0, 0..63
+
+    bool is_valid() const;
+    std::vector<RtpDtmfPaket> compile(int ptime_ms) const;
+    std::shared_ptr<const RtpDtmfPlan> compile_plan(const std::vector<int>& ptimes_ms) const;
+
+    static bool event_code(QChar digit, uint8_t& code);
+};
+
+#endif // RTPDTMF_H
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpengine.h/cpp:
+ *The RtpEngine-Class is the RTP-sender of the application. It drives one
+ *or many (load-mode) RTP-streams, each with its own destination, SSRC,
+ *sequence and timestamp. The streams are spread round-robin over a pool
+ *of RtpWorker-threads (see rtpworker.h/cpp), which schedule every paket
+ *against an absolute deadline on the monotonic RtpClock. Because the
+ *deadlines are absolute (start + n * ptime) a late wakeup does not shift
+ *the following pakets, so there is no drift.
+ *Per stream the workers measure how late each paket left the socket and
+ *report these jitter-statistics periodically to the ui, together with the
+ *datagram- and syscall-counters of their RtpTransport.
+ *Optional the payload is real audio out of a RtpAudioAsset, which all
+ *streams share without copying it.
+ *DTMF (RFC 4733) is compiled once and fired on all running streams with a
+ *telephone-event payload-type.
+ *The ui (mainwindow.cpp) only starts and stops the engine and fires DTMF.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpengine.h"
+#include "rtpworker.h"
+#include "rtpstream.h"
+
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <QSet>
+
+#include <algorithm>
+
+RtpEngine::RtpEngine(QObject* parent) : QObject(parent) {
+    qRegisterMetaType<RtpStreamStats>("RtpStreamStats");
+    qRegisterMetaType<QVector<RtpStreamStats>>("QVector<RtpStreamStats>");
+}
+
+RtpEngine::~RtpEngine() {
+    RtpEngine::join_workers();
+}
+
+bool RtpEngine::start(const RtpStreamConfig& config) {
+    return RtpEngine::start(QVector<RtpStreamConfig>{config}, 1);
+}
+
+bool RtpEngine::start(const QVector<RtpStreamConfig>& streams, int worker_count) {
+    if (!m_threads.isEmpty()) {
+        qWarning() << "RTP-Engine already running";
+        return false;
+    }
+    if (streams.isEmpty()) {
+        qWarning() << "No RTP-streams configured";
+        return false;
+    }
+    //Resolve the SSRCs up front: configured ones are taken as they are,
+    //random ones are drawn until they are unique inside this engine
+    QVector<RtpStreamConfig> configs = streams;
+    for (RtpStreamConfig& config : configs) {
+        if (config.scenario && !config.scenario->start_ssrc.isEmpty()) {
+            config.ssrc = config.scenario->start_ssrc;
+        }
+        if (config.scenario && config.scenario->start_sequence >= 0) {
+            config.start_sequence = config.scenario->start_sequence;
+        }
+    }
+
+    QSet<uint32_t> used_ssrcs;
+    for (const RtpStreamConfig& config : configs) {
+        uint32_t ssrc = 0;
+        if (!config.ssrc.isEmpty()) {
+            if (!RtpStream::parse_ssrc(config.ssrc, ssrc)) {
+                qWarning() << "Invalid SSRC: " << config.ssrc;
+                return false;
+            }
+            used_ssrcs.insert(ssrc);
+        }
+    }
+
+    std::vector<RtpStream> rtp_streams(configs.size());
+    for (int i = 0; i < configs.size(); ++i) {
+        const RtpStreamConfig& config = configs[i];
+        uint32_t ssrc = 0;
+        if (config.ssrc.isEmpty()) {
+            do {
+                ssrc = RtpStream::random_ssrc();
+            } while (used_ssrcs.contains(ssrc));
+            used_ssrcs.insert(ssrc);
+        } else {
+            RtpStream::parse_ssrc(config.ssrc, ssrc);
+        }
+
+        if (!rtp_streams[i].init(config, ssrc, quint32(i), used_ssrcs)) {
+            return false;
+        }
+    }
+
+    m_ptimes_ms.clear();
+    for (const RtpStreamConfig& config : configs) {
+        if (std::find(m_ptimes_ms.begin(), m_ptimes_ms.end(), config.ptime_ms) == m_ptimes_ms.end()) {
+            m_ptimes_ms.push_back(config.ptime_ms);
+        }
+    }
+
+    if (worker_count <= 0) {
+        worker_count = QThread::idealThreadCount();
+    }
+    worker_count = qBound(1, worker_count, int(streams.size()));
+
+    m_running.store(true);
+    m_datagrams.store(0);
+    m_syscalls.store(0);
+    m_dropped.store(0);
+    m_workers.clear();
+    for (int i = 0; i < worker_count; ++i) {
+        m_workers.emplace_back(new RtpWorker(m_running, [this](const QVector<RtpStreamStats>& stats, const RtpTransportStats& transport_delta) {
+            m_datagrams.fetch_add(transport_delta.datagrams, std::memory_order_relaxed);
+            m_syscalls.fetch_add(transport_delta.syscalls, std::memory_order_relaxed);
+            m_dropped.fetch_add(transport_delta.dropped, std::memory_order_relaxed);
+            emit stream_stats(stats);
+        }));
+    }
+    for (int i = 0; i < int(rtp_streams.size()); ++i) {
+        m_workers[i % worker_count]->add_stream(rtp_streams[i]);
+    }
+
+    for (int i = 0; i < worker_count; ++i) {
+        RtpWorker* worker = m_workers[i].get();
+        QThread* thread = QThread::create([worker]() { worker->run(); });
+        thread->setObjectName(QString("RtpWorker%1").arg(i));
+        thread->setParent(this);
+        connect(thread, &QThread::finished, this, [this, thread]() {
+            thread->deleteLater();
+            if (m_threads.removeOne(thread) && m_threads.isEmpty()) {
+                m_workers.clear();
+                emit stopped();
+            }
+        });
+        m_threads.push_back(thread);
+    }
+
+    qDebug() << "RTP-Engine started with" << streams.size() << "streams on" << worker_count << "workers";
+    for (QThread* thread : m_threads) {
+        thread->start(QThread::TimeCriticalPriority);
+    }
+    return true;
+}
+
+void RtpEngine::stop() {
+    if (RtpEngine::join_workers()) {
+        emit stopped();
+    }
+}
+
+bool RtpEngine::join_workers() {
+    m_running.store(false);
+    if (m_threads.isEmpty()) {
+        return false;
+    }
+
+    for (QThread* thread : m_threads) {
+        thread->wait();
+    }
+    m_threads.clear();
+    m_workers.clear();
+    return true;
+}
+
+bool RtpEngine::is_running() const {
+    return !m_threads.isEmpty();
+}
+
+RtpTransportStats RtpEngine::transport_stats() const {
+    RtpTransportStats stats;
+    stats.datagrams = m_datagrams.load(std::memory_order_relaxed);
+    stats.syscalls = m_syscalls.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool RtpEngine::send_dtmf(const RtpDtmfSequence& sequence) {
+    if (m_workers.empty()) {
+        qWarning() << "RTP-Engine not running, no DTMF sent";
+        return false;
+    }
+    //Compiled once, every worker and stream shares the same plan
+    std::shared_ptr<const RtpDtmfPlan> plan = sequence.compile_plan(m_ptimes_ms);
+    if (!plan) {
+        return false;
+    }
+    for (const std::unique_ptr<RtpWorker>& worker : m_workers) {
+        worker->fire_dtmf(plan);
+    }
+    return true;
+}
+
+//Format of a stream-list (one line per stream-group, '#' starts a comment):
+//destination;port;payload-type;ssrc;ptime;paket-count;repeat;event-payload-type
+//With repeat > 1 the line is expanded to that many streams, each using the
+//next RTP-port (port + 2) and the next SSRC (ssrc + 1).
+//An empty ssrc or "random" gives every stream a random SSRC.
+//Without event-payload-type (RFC 4733 telephone-event) the streams send no DTMF.
+bool RtpEngine::load_stream_list(const QString& path, QVector<RtpStreamConfig>& streams) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open stream-list:" << path;
+        return false;
+    }
+
+    QTextStream in(&file);
+    int line_nr = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        line_nr++;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        QStringList fields = line.split(';');
+        if (fields.size() < 4) {
+            qWarning() << "Stream-list line" << line_nr << "needs at least destination;port;payload-type;ssrc";
+            return false;
+        }
+
+        RtpStreamConfig config;
+        config.destination = QHostAddress(fields[0].trimmed());
+        config.port = fields[1].trimmed().toUShort();
+        config.payload_type = fields[2].trimmed();
+        QString ssrc_field = fields[3].trimmed();
+        if (fields.size() > 4) config.ptime_ms = fields[4].trimmed().toInt();
+        if (fields.size() > 5) config.packet_count = fields[5].trimmed().toULongLong();
+        int repeat = fields.size() > 6 ? fields[6].trimmed().toInt() : 1;
+        if (fields.size() > 7) config.event_payload_type = fields[7].trimmed().toInt();
+
+        bool random_ssrc = ssrc_field.isEmpty() || ssrc_field.compare("random", Qt::CaseInsensitive) == 0;
+        uint32_t ssrc = 0;
+        bool ok = random_ssrc || RtpStream::parse_ssrc(ssrc_field, ssrc);
+        if (config.destination.isNull() || config.port == 0 || !ok) {
+            qWarning() << "Invalid stream-list line" << line_nr << ":" << line;
+            return false;
+        }
+
+        for (int i = 0; i < qMax(1, repeat); ++i) {
+            RtpStreamConfig stream = config;
+            stream.port = quint16(config.port + 2 * i);
+            if (!random_ssrc) {
+                stream.ssrc = QString("0x%1").arg(ssrc + uint32_t(i), 8, 16, QChar('0'));
+            }
+            streams.push_back(stream);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpengine.h/cpp:
+ *The RtpEngine-Class is the RTP-sender of the application. It drives one
+ *or many (load-mode) RTP-streams, each with its own destination, SSRC,
+ *sequence and timestamp. The streams are spread round-robin over a pool
+ *of RtpWorker-threads (see rtpworker.h/cpp), which schedule every paket
+ *against an absolute deadline on the monotonic RtpClock. Because the
+ *deadlines are absolute (start + n * ptime) a late wakeup does not shift
+ *the following pakets, so there is no drift.
+ *Per stream the workers measure how late each paket left the socket and
+ *report these jitter-statistics periodically to the ui, together with the
+ *datagram- and syscall-counters of their RtpTransport.
+ *Optional the payload is real audio out of a RtpAudioAsset, which all
+ *streams share without copying it.
+ *DTMF (RFC 4733) is compiled once and fired on all running streams with a
+ *telephone-event payload-type.
+ *The ui (mainwindow.cpp) only starts and stops the engine and fires DTMF.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPENGINE_H
+#define RTPENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QHostAddress>
+#include <QMetaType>
+#include <QVector>
+
+#include "rtpaudioasset.h"
+#include "rtpdtmf.h"
+#include "rtpscenario.h"
+#include "rtpsockethandle.h"
+#include "rtptransport.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class QThread;
+class RtpWorker;
+
+struct RtpStreamConfig {
+    QString payload_type = "PCMA";
+    QString ssrc;               //empty = random SSRC (RFC 3550)
+    int start_sequence = -1;    //-1 = random start sequence (RFC 3550)
+    QHostAddress destination = QHostAddress("127.0.0.1");
+    quint16 port = 4000;
+    int ptime_ms = 20;
+    quint64 packet_count = 0;   //0 = send until stopped
+    std::shared_ptr<const RtpScenario> scenario;    //Advanced RTP-Flow, shared by all streams
+    std::shared_ptr<const RtpAudioAsset> audio;     //nullptr = constant filler-payload
+    int rtcp_interval_ms = 5000;    //0 = no RTCP, randomized by 0.5..1.5 (RFC 3550 6.3.1)
+    quint16 rtcp_port = 0;          //0 = port + 1
+    std::shared_ptr<const RtpSocketHandle> socket;  //nullptr = own socket of the worker, else e.g. the call's media-socket
+    int event_payload_type = -1;    //RFC 4733 telephone-event as negotiated, -1 = none
+};
+
+struct RtpStreamStats {
+    quint32 stream_id = 0;
+    quint32 ssrc = 0;        //current SSRC, may change during a scenario
+    quint64 packets_sent = 0;
+    double mean_lateness_us = 0.0;
+    double max_lateness_us = 0.0;
+    double jitter_us = 0.0;     //RFC 3550 style smoothed deviation of the send-interval
+    quint32 resyncs = 0;        //how often the schedule had to be rebased (e.g. host suspended)
+    quint32 rtcp_sent = 0;
+    quint32 rtcp_received = 0;  //reports of the far end about this stream
+    double rtt_ms = -1.0;       //from the last report referring to one of our SRs, -1 = unknown
+    double remote_loss_percent = 0.0;   //fraction lost of the last report
+    qint32 remote_lost = 0;     //cumulative lost of the last report
+    double remote_jitter_ms = 0.0;
+    quint32 dtmf_events = 0;    //RFC 4733 events started
+};
+Q_DECLARE_METATYPE(RtpStreamStats)
+Q_DECLARE_METATYPE(QVector<RtpStreamStats>)
+
+class RtpEngine : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RtpEngine(QObject* parent = nullptr);
+    ~RtpEngine();
+
+    bool start(const RtpStreamConfig& config);
+    bool start(const QVector<RtpStreamConfig>& streams, int worker_count = 0);
+    void stop();
+    bool is_running() const;
+    RtpTransportStats transport_stats() const;
+    //Fires the sequence on every stream with a telephone-event payload-type
+    bool send_dtmf(const RtpDtmfSequence& sequence);
+
+    static bool load_stream_list(const QString& path, QVector<RtpStreamConfig>& streams);
+
+signals:
+    void stream_stats(const QVector<RtpStreamStats>& stats);
+    void stopped();
+
+private:
+    bool join_workers();
+
+    QVector<QThread*> m_threads;
+    std::vector<std::unique_ptr<RtpWorker>> m_workers;
+    std::vector<int> m_ptimes_ms;   //distinct ptimes of the running streams, a DTMF-plan is compiled for each
+    std::atomic<bool> m_running{false};
+    std::atomic<quint64> m_datagrams{0};
+    std::atomic<quint64> m_syscalls{0};
+    std::atomic<quint64> m_dropped{0};
+};
+
+#endif // RTPENGINE_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtppacketbuilder.h/cpp:
+ *The RtpPacketBuilder-Class resolves everything which is constant for a
+ *RTP-stream (payload-type, SSRC, paket-size, timestamp-step, payload) once
+ *when the stream is created and renders it into a paket-template.
+ *The RtpPacketPool-Class is a fixed-size, preallocated paket-memory for all
+ *streams of one RtpWorker. Every stream owns a small ring of slots which are
+ *filled with its template once, so sending a paket only patches sequence
+ *and timestamp in place. The per-paket hot path is allocation-free.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtppacketbuilder.h"
+
+#include <QDebug>
+
+#include <cstring>
+
+bool RtpPacketBuilder::init(const QString& payload_type, uint32_t ssrc, int ptime_ms) {
+    //PCMU, PCMA and G722 all send 8 byte per ms with a 8kHz RTP-clock (RFC 3551)
+    QString codec = payload_type.toUpper();
+    if (codec == "PCMU") {
+        m_pt = 0;
+        m_payload_fill = 0xFF;
+    } else if (codec == "PCMA") {
+        m_pt = 8;
+        m_payload_fill = 0xFF;
+    } else if (codec == "G722") {
+        m_pt = 9;
+        m_payload_fill = 0x00;
+    } else {
+        qWarning() << "Unsupported payload type: " << payload_type;
+        return false;
+    }
+
+    if (ptime_ms <= 0 || header_size + ptime_ms * 8 > max_paket_size) {
+        qWarning() << "Unsupported ptime: " << ptime_ms;
+        return false;
+    }
+    m_timestamp_step = uint32_t(ptime_ms) * 8;
+    m_payload_size = ptime_ms * 8;
+    m_ssrc = ssrc;
+
+    return true;
+}
+
+void RtpPacketBuilder::write_template(uint8_t* paket) const {
+    paket[0] = (2 << 6);
+    paket[1] = m_pt & 0x7F;
+    RtpPacketBuilder::patch(paket, 0, 0);
+    RtpPacketBuilder::patch_ssrc(paket, m_ssrc);
+    memset(paket + header_size, m_payload_fill, m_payload_size);
+}
+
+void RtpPacketPool::init(int stream_count, int max_paket_size) {
+    //Slots are kept 16 byte aligned relative to each other
+    m_slot_size = (size_t(max_paket_size) + 15) & ~size_t(15);
+    m_memory.assign(size_t(stream_count) * ring_depth * m_slot_size, 0);
+}
+
+void RtpPacketPool::init_stream(int stream, const RtpPacketBuilder& builder) {
+    for (int i = 0; i < ring_depth; ++i) {
+        builder.write_template(RtpPacketPool::slot(stream, i));
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtppacketbuilder.h/cpp:
+ *The RtpPacketBuilder-Class resolves everything which is constant for a
+ *RTP-stream (payload-type, SSRC, paket-size, timestamp-step, payload) once
+ *when the stream is created and renders it into a paket-template.
+ *The RtpPacketPool-Class is a fixed-size, preallocated paket-memory for all
+ *streams of one RtpWorker. Every stream owns a small ring of slots which are
+ *filled with its template once, so sending a paket only patches sequence
+ *and timestamp in place. The per-paket hot path is allocation-free.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPPACKETBUILDER_H
+#define RTPPACKETBUILDER_H
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+class RtpPacketBuilder {
+
+public:
+    static const int header_size = 12;
+    //Largest RTP-paket fitting into a not fragmented IPv4/UDP datagram on ethernet
+    static const int max_paket_size = 1472;
+
+    bool init(const QString& payload_type, uint32_t ssrc, int ptime_ms);
+
+    uint8_t payload_type() const { return m_pt; }
+    uint32_t ssrc() const { return m_ssrc; }
+    uint32_t timestamp_step() const { return m_timestamp_step; }
+    int payload_size() const { return m_payload_size; }
+    int paket_size() const { return header_size + m_payload_size; }
+
+    void set_ssrc(uint32_t ssrc) { m_ssrc = ssrc; }
+    void write_template(uint8_t* paket) const;
+
+    static inline void patch(uint8_t* paket, uint16_t sequence, uint32_t timestamp) {
+        paket[2] = uint8_t(sequence >> 8);
+        paket[3] = uint8_t(sequence);
+        paket[4] = uint8_t(timestamp >> 24);
+        paket[5] = uint8_t(timestamp >> 16);
+        paket[6] = uint8_t(timestamp >> 8);
+        paket[7] = uint8_t(timestamp);
+    }
+
+    static inline void patch_ssrc(uint8_t* paket, uint32_t ssrc) {
+        paket[8] = uint8_t(ssrc >> 24);
+        paket[9] = uint8_t(ssrc >> 16);
+        paket[10] = uint8_t(ssrc >> 8);
+        paket[11] = uint8_t(ssrc);
+    }
+
+private:
+    uint8_t m_pt = 0;
+    uint8_t m_payload_fill = 0;
+    uint32_t m_ssrc = 0;
+    uint32_t m_timestamp_step = 0;
+    int m_payload_size = 0;
+};
+
+class RtpPacketPool {
+
+public:
+    //Slots per stream - has to be larger than the number of pakets one
+    //stream can have in flight during one scheduling tick
+    static const int ring_depth = 8;
+
+    void init(int stream_count, int max_paket_size);
+    void init_stream(int stream, const RtpPacketBuilder& builder);
+
+    inline uint8_t* slot(int stream, uint64_t paket_nr) {
+        return m_memory.data() + (size_t(stream) * ring_depth + size_t(paket_nr % ring_depth)) * m_slot_size;
+    }
+
+private:
+    std::vector<uint8_t> m_memory;
+    size_t m_slot_size = 0;
+};
+
+#endif // RTPPACKETBUILDER_H
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpreceiver.h/cpp:
+ *The RtpReceiver-Class is the receiving counterpart of the RtpEngine.
+ *It binds a range of UDP-ports, splits it into contiguous chunks for
+ *its RtpReceiveWorker-threads and publishes the per-stream analysis
+ *(loss, jitter, reordering, duplicates) once per second to the ui.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpreceiver.h"
+#include "rtpreceiveworker.h"
+
+#include <QThread>
+#include <QDebug>
+
+RtpReceiver::RtpReceiver(QObject* parent) : QObject(parent) {
+    qRegisterMetaType<RtpReceiveStats>("RtpReceiveStats");
+    qRegisterMetaType<QVector<RtpReceiveStats>>("QVector<RtpReceiveStats>");
+}
+
+RtpReceiver::~RtpReceiver() {
+    RtpReceiver::join_workers();
+}
+
+bool RtpReceiver::start(const RtpReceiverConfig& config) {
+    if (!m_threads.isEmpty()) {
+        qWarning() << "RTP-Receiver already running";
+        return false;
+    }
+    if (config.port_count <= 0 || int(config.first_port) + config.port_count - 1 > 65535) {
+        qWarning() << "Invalid RTP-receive port-range:" << config.first_port << "+" << config.port_count;
+        return false;
+    }
+
+    int worker_count = config.threads;
+    if (worker_count <= 0) {
+        worker_count = QThread::idealThreadCount();
+    }
+    worker_count = qBound(1, worker_count, config.port_count);
+
+    m_running.store(true);
+    m_datagrams.store(0);
+    m_syscalls.store(0);
+    m_invalid.store(0);
+    m_workers.clear();
+
+    //Contiguous chunks: every SSRC of a port is analysed by exactly one worker, no locking needed
+    int first = config.first_port;
+    for (int i = 0; i < worker_count; ++i) {
+        int count = config.port_count / worker_count + (i < config.port_count % worker_count ? 1 : 0);
+        m_workers.emplace_back(new RtpReceiveWorker(m_running, config.bind_address, quint16(first), count,
+            [this](const QVector<RtpReceiveStats>& stats, const RtpReceiveCounters& delta) {
+                m_datagrams.fetch_add(delta.datagrams, std::memory_order_relaxed);
+                m_syscalls.fetch_add(delta.syscalls, std::memory_order_relaxed);
+                m_invalid.fetch_add(delta.invalid, std::memory_order_relaxed);
+                if (!stats.isEmpty()) {
+                    emit receive_stats(stats);
+                }
+            }));
+        first += count;
+    }
+
+    for (int i = 0; i < worker_count; ++i) {
+        RtpReceiveWorker* worker = m_workers[i].get();
+        QThread* thread = QThread::create([worker]() { worker->run(); });
+        thread->setObjectName(QString("RtpReceiveWorker%1").arg(i));
+        thread->setParent(this);
+        connect(thread, &QThread::finished, this, [this, thread]() {
+            thread->deleteLater();
+            if (m_threads.removeOne(thread) && m_threads.isEmpty()) {
+                m_workers.clear();
+                emit stopped();
+            }
+        });
+        m_threads.push_back(thread);
+    }
+
+    qDebug() << "RTP-Receiver started on" << config.port_count << "ports from" << config.first_port << "with" << worker_count << "workers";
+    for (QThread* thread : m_threads) {
+        thread->start(QThread::TimeCriticalPriority);
+    }
+    return true;
+}
+
+void RtpReceiver::stop() {
+    if (RtpReceiver::join_workers()) {
+        emit stopped();
+    }
+}
+
+bool RtpReceiver::join_workers() {
+    m_running.store(false);
+    if (m_threads.isEmpty()) {
+        return false;
+    }
+
+    for (QThread* thread : m_threads) {
+        thread->wait();
+    }
+    m_threads.clear();
+    m_workers.clear();
+    return true;
+}
+
+bool RtpReceiver::is_running() const {
+    return !m_threads.isEmpty();
+}
+
+RtpReceiverTotals RtpReceiver::totals() const {
+    RtpReceiverTotals totals;
+    totals.datagrams = m_datagrams.load(std::memory_order_relaxed);
+    totals.syscalls = m_syscalls.load(std::memory_order_relaxed);
+    totals.invalid = m_invalid.load(std::memory_order_relaxed);
+    return totals;
+}
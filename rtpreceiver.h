@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpreceiver.h/cpp:
+ *The RtpReceiver-Class is the receiving counterpart of the RtpEngine.
+ *It binds a range of UDP-ports, splits it into contiguous chunks for
+ *its RtpReceiveWorker-threads and publishes the per-stream analysis
+ *(loss, jitter, reordering, duplicates) once per second to the ui.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPRECEIVER_H
+#define RTPRECEIVER_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QMetaType>
+#include <QVector>
+
+#include "rtpreceivestream.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class QThread;
+class RtpReceiveWorker;
+
+struct RtpReceiverConfig {
+    QHostAddress bind_address = QHostAddress(QHostAddress::Any);
+    quint16 first_port = 4000;
+    int port_count = 1;
+    int threads = 0;            //0 = one per core, never more than ports
+};
+
+struct RtpReceiverTotals {
+    quint64 datagrams = 0;
+    quint64 syscalls = 0;
+    quint64 invalid = 0;
+};
+Q_DECLARE_METATYPE(RtpReceiveStats)
+Q_DECLARE_METATYPE(QVector<RtpReceiveStats>)
+
+class RtpReceiver : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RtpReceiver(QObject* parent = nullptr);
+    ~RtpReceiver();
+
+    bool start(const RtpReceiverConfig& config);
+    void stop();
+    bool is_running() const;
+    RtpReceiverTotals totals() const;
+
+signals:
+    //Only the streams that received pakets since the last report of their worker
+    void receive_stats(const QVector<RtpReceiveStats>& stats);
+    void stopped();
+
+private:
+    bool join_workers();
+
+    QVector<QThread*> m_threads;
+    std::vector<std::unique_ptr<RtpReceiveWorker>> m_workers;
+    std::atomic<bool> m_running{false};
+    std::atomic<quint64> m_datagrams{0};
+    std::atomic<quint64> m_syscalls{0};
+    std::atomic<quint64> m_invalid{0};
+};
+
+#endif // RTPRECEIVER_H
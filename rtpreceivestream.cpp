@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpreceivestream.h/cpp:
+ *The RtpReceiveStream-Class analyses one received RTP-stream online,
+ *paket by paket and without storing pakets: sequence-tracking with
+ *cycles, loss, reordering and duplicates (RFC 3550 A.1/A.3), the
+ *interarrival-jitter (RFC 3550 A.8) and the largest arrival-gap.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "rtpreceivestream.h"
+
+#include <cstdlib>
+
+const uint32_t rtp_seq_mod = 1 << 16;
+const uint16_t max_dropout = 3000;
+const uint16_t max_misorder = 100;
+
+void RtpReceiveStream::init(uint32_t ssrc, uint16_t port, uint8_t payload_type, uint16_t sequence, uint32_t timestamp, int64_t arrival_ns) {
+    //No probation: the pakets are demultiplexed by SSRC, the first one starts the stream
+    *this = RtpReceiveStream();
+    m_ssrc = ssrc;
+    m_port = port;
+    m_payload_type = payload_type;
+    m_clock_rate = clock_rate(payload_type);
+
+    m_base_seq = sequence;
+    m_max_seq = sequence;
+    m_bad_seq = rtp_seq_mod + 1;
+    m_received = 1;
+    m_window = 1;
+
+    m_start_ns = arrival_ns;
+    m_last_transit = -int64_t(timestamp);
+    m_last_arrival_ns = arrival_ns;
+}
+
+void RtpReceiveStream::on_paket(uint16_t sequence, uint32_t timestamp, int64_t arrival_ns) {
+    uint16_t delta = uint16_t(sequence - m_max_seq);
+
+    if (delta == 0) {
+        m_duplicates++;
+        return;
+    }
+
+    if (delta < max_dropout) {
+        //In order, with a permissible gap
+        if (sequence < m_max_seq) {
+            m_cycles += rtp_seq_mod;
+        }
+        m_window = delta >= 64 ? 1 : (m_window << delta) | 1;
+        m_max_seq = sequence;
+
+        int64_t gap = arrival_ns - m_last_arrival_ns;
+        if (gap > m_max_gap_ns) {
+            m_max_gap_ns = gap;
+        }
+        m_last_arrival_ns = arrival_ns;
+    } else if (delta <= rtp_seq_mod - max_misorder) {
+        //Very large jump: two sequential pakets restart the statistic (sender restarted, RFC 3550 A.1)
+        if (sequence == m_bad_seq) {
+            RtpReceiveStream::init(m_ssrc, m_port, m_payload_type, sequence, timestamp, arrival_ns);
+            return;
+        }
+        m_bad_seq = (uint32_t(sequence) + 1) & (rtp_seq_mod - 1);
+        return;
+    } else {
+        //Late paket: a duplicate if its bit in the window is already set
+        uint16_t back = uint16_t(m_max_seq - sequence);
+        if (back < 64) {
+            uint64_t bit = uint64_t(1) << back;
+            if (m_window & bit) {
+                m_duplicates++;
+                return;
+            }
+            m_window |= bit;
+        }
+        m_reordered++;
+    }
+
+    m_received++;
+    RtpReceiveStream::update_jitter(timestamp, arrival_ns);
+}
+
+void RtpReceiveStream::update_jitter(uint32_t timestamp, int64_t arrival_ns) {
+    //Arrival in timestamp-units relative to the first paket, a double keeps the product out of the overflow
+    int64_t arrival = int64_t(double(arrival_ns - m_start_ns) * m_clock_rate / 1e9);
+    int64_t transit = arrival - int64_t(timestamp);
+    int64_t d = transit - m_last_transit;
+    m_last_transit = transit;
+    //The timestamp wraps after 2^32, a wrap shows up as a huge d and is not counted
+    if (d < 0) {
+        d = -d;
+    }
+    if (d > int64_t(1) << 31) {
+        return;
+    }
+    m_jitter += uint32_t(d) - ((m_jitter + 8) >> 4);
+}
+
+RtpReceiveStats RtpReceiveStream::stats() const {
+    RtpReceiveStats stats;
+    stats.ssrc = m_ssrc;
+    stats.port = m_port;
+    stats.payload_type = m_payload_type;
+    stats.packets = m_received;
+    stats.reordered = m_reordered;
+    stats.duplicates = m_duplicates;
+
+    uint64_t extended_max = uint64_t(m_cycles) + m_max_seq;
+    int64_t expected = int64_t(extended_max - m_base_seq + 1);
+    stats.lost = expected - int64_t(m_received);
+    stats.loss_percent = expected > 0 ? 100.0 * double(stats.lost) / double(expected) : 0.0;
+    stats.jitter_ms = double(m_jitter >> 4) * 1000.0 / double(m_clock_rate);
+    stats.max_gap_ms = double(m_max_gap_ns) / 1e6;
+    return stats;
+}
+
+bool RtpReceiveStream::changed_since_report() const {
+    return m_received != m_reported_received;
+}
+
+void RtpReceiveStream::mark_reported() {
+    m_reported_received = m_received;
+}
+
+uint32_t RtpReceiveStream::clock_rate(uint8_t payload_type) {
+    //G.722 uses 8000 Hz as RTP-clock too (RFC 3551), dynamic types are assumed as telephony
+    switch (payload_type) {
+    case 10:
+    case 11:
+        return 44100;
+    case 14:
+    case 25:
+    case 26:
+    case 28:
+    case 31:
+    case 32:
+    case 33:
+    case 34:
+        return 90000;
+    default:
+        return 8000;
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpreceivestream.h/cpp:
+ *The RtpReceiveStream-Class analyses one received RTP-stream online,
+ *paket by paket and without storing pakets: sequence-tracking with
+ *cycles, loss, reordering and duplicates (RFC 3550 A.1/A.3), the
+ *interarrival-jitter (RFC 3550 A.8) and the largest arrival-gap.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPRECEIVESTREAM_H
+#define RTPRECEIVESTREAM_H
+
+#include <QtGlobal>
+
+#include <cstdint>
+
+struct RtpReceiveStats {
+    quint32 ssrc = 0;
+    quint16 port = 0;           //local port the stream arrived on
+    quint8 payload_type = 0;
+    quint64 packets = 0;        //without duplicates
+    qint64 lost = 0;            //expected - received, negative if the sender repeats pakets
+    double loss_percent = 0.0;
+    double jitter_ms = 0.0;
+    double max_gap_ms = 0.0;    //largest interarrival-time of in-order pakets
+    quint64 reordered = 0;
+    quint64 duplicates = 0;
+};
+
+class RtpReceiveStream {
+
+public:
+    void init(uint32_t ssrc, uint16_t port, uint8_t payload_type, uint16_t sequence, uint32_t timestamp, int64_t arrival_ns);
+    void on_paket(uint16_t sequence, uint32_t timestamp, int64_t arrival_ns);
+    RtpReceiveStats stats() const;
+    bool changed_since_report() const;
+    void mark_reported();
+
+    static uint32_t clock_rate(uint8_t payload_type);
+
+private:
+    void update_jitter(uint32_t timestamp, int64_t arrival_ns);
+
+    uint32_t m_ssrc = 0;
+    uint16_t m_port = 0;
+    uint8_t m_payload_type = 0;
+    uint32_t m_clock_rate = 8000;
+
+    //RFC 3550 A.1
+    uint16_t m_max_seq = 0;
+    uint32_t m_cycles = 0;
+    uint32_t m_base_seq = 0;
+    uint32_t m_bad_seq = 0;
+    uint64_t m_received = 0;
+    //Bit i = paket max_seq - i was received, to tell duplicates from reordered pakets
+    uint64_t m_window = 0;
+    uint64_t m_reordered = 0;
+    uint64_t m_duplicates = 0;
+
+    //RFC 3550 A.8, jitter in timestamp-units scaled by 16
+    int64_t m_start_ns = 0;
+    int64_t m_last_transit = 0;
+    uint32_t m_jitter = 0;
+    int64_t m_last_arrival_ns = 0;
+    int64_t m_max_gap_ns = 0;
+
+    uint64_t m_reported_received = 0;
+};
+
+#endif // RTPRECEIVESTREAM_H
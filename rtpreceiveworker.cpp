@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpreceiveworker.h/cpp:
+ *The RtpReceiveWorker-Class receives the RTP-pakets of a range of local
+ *ports on its own thread. On Linux all sockets of the range are watched
+ *by one epoll and read with recvmmsg straight into a fixed set of
+ *buffers (kernel-timestamps per paket), elsewhere QUdpSocket is used and
+ *the native descriptors of all ports are waited for with poll/WSAPoll.
+ *The pakets are demultiplexed by SSRC/port through the RtpSsrcTable and
+ *analysed in place, no paket is copied out of the receive-buffers.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "rtpreceiveworker.h"
+#include "rtpclock.h"
+
+#include <QUdpSocket>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#if defined(Q_OS_WIN)
+#include <winsock2.h>
+#elif defined(Q_OS_UNIX)
+#include <poll.h>
+#endif
+
+//Reports are sent to the ui once per second per worker
+const int64_t stats_interval_ns = 1000000000LL;
+const int receive_timeout_ms = 50;
+
+class RtpReceiveBackend {
+
+public:
+    virtual ~RtpReceiveBackend() = default;
+
+    virtual bool open(const QHostAddress& address, quint16 first_port, int port_count) = 0;
+    //Waits at most timeout_ms and hands every received datagram to the worker
+    virtual void receive(RtpReceiveWorker& worker, int timeout_ms) = 0;
+    virtual const char* name() const = 0;
+
+    static std::unique_ptr<RtpReceiveBackend> create();
+};
+
+#ifdef Q_OS_LINUX
+//Kernel-limit of recvmmsg is UIO_MAXIOV, 64 pakets per call are enough to empty a busy socket quickly
+const int receive_batch = 64;
+const int receive_buffer_size = 2048;
+const int receive_socket_buffer = 4 * 1024 * 1024;
+//A busy socket may not starve the others of the range
+const int max_batches_per_wakeup = 16;
+
+class MmsgRtpReceiveBackend : public RtpReceiveBackend {
+
+public:
+    ~MmsgRtpReceiveBackend() override {
+        for (const Socket& socket : m_sockets) {
+            ::close(socket.fd);
+        }
+        if (m_epoll >= 0) {
+            ::close(m_epoll);
+        }
+    }
+
+    bool open(const QHostAddress& address, quint16 first_port, int port_count) override {
+        m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll < 0) {
+            return false;
+        }
+
+        for (int i = 0; i < port_count; ++i) {
+            quint16 port = quint16(first_port + i);
+            int fd = MmsgRtpReceiveBackend::open_socket(address, port);
+            if (fd < 0) {
+                qWarning() << "RTP-receiver: cannot bind port" << port << ":" << strerror(errno);
+                continue;
+            }
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u32 = uint32_t(m_sockets.size());
+            ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event);
+            m_sockets.push_back({fd, port});
+        }
+
+        //One set of buffers for all sockets, the pakets are analysed before the next recvmmsg
+        m_buffers.resize(size_t(receive_batch) * receive_buffer_size);
+        m_msgs.resize(receive_batch);
+        m_iov.resize(receive_batch);
+        m_cmsg.resize(receive_batch);
+        for (int i = 0; i < receive_batch; ++i) {
+            m_iov[i].iov_base = &m_buffers[size_t(i) * receive_buffer_size];
+            m_iov[i].iov_len = receive_buffer_size;
+        }
+        return !m_sockets.empty();
+    }
+
+    void receive(RtpReceiveWorker& worker, int timeout_ms) override {
+        epoll_event events[64];
+        int count = ::epoll_wait(m_epoll, events, 64, timeout_ms);
+        for (int i = 0; i < count; ++i) {
+            MmsgRtpReceiveBackend::drain(worker, m_sockets[events[i].data.u32]);
+        }
+    }
+
+    const char* name() const override {
+        return "recvmmsg";
+    }
+
+private:
+    struct Socket {
+        int fd;
+        uint16_t port;
+    };
+
+    union ControlBuffer {
+        char buffer[CMSG_SPACE(sizeof(timespec))];
+        cmsghdr align;
+    };
+
+    static int open_socket(const QHostAddress& address, quint16 port) {
+        sockaddr_storage storage{};
+        socklen_t len = 0;
+        int family = AF_INET6;
+        if (address.protocol() == QAbstractSocket::IPv4Protocol && address != QHostAddress(QHostAddress::Any)) {
+            family = AF_INET;
+            sockaddr_in* sin = reinterpret_cast<sockaddr_in*>(&storage);
+            sin->sin_family = AF_INET;
+            sin->sin_port = htons(port);
+            sin->sin_addr.s_addr = htonl(address.toIPv4Address());
+            len = sizeof(sockaddr_in);
+        } else {
+            //Any binds dual-stack, IPv4-senders arrive as v4-mapped
+            sockaddr_in6* sin6 = reinterpret_cast<sockaddr_in6*>(&storage);
+            sin6->sin6_family = AF_INET6;
+            sin6->sin6_port = htons(port);
+            if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+                Q_IPV6ADDR ip6 = address.toIPv6Address();
+                memcpy(&sin6->sin6_addr, &ip6, sizeof(ip6));
+            } else {
+                sin6->sin6_addr = in6addr_any;
+            }
+            len = sizeof(sockaddr_in6);
+        }
+
+        int fd = ::socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (family == AF_INET6) {
+            int v6only = 0;
+            setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only));
+        }
+        int buffer = receive_socket_buffer;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+        //Arrival-time out of the kernel, the jitter is not falsified by our own scheduling
+        int timestamps = 1;
+        setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &timestamps, sizeof(timestamps));
+
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&storage), len) < 0) {
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            return -1;
+        }
+        return fd;
+    }
+
+    void drain(RtpReceiveWorker& worker, const Socket& socket) {
+        RtpReceiveCounters& counters = worker.counters();
+        for (int batch = 0; batch < max_batches_per_wakeup; ++batch) {
+            for (int i = 0; i < receive_batch; ++i) {
+                msghdr& hdr = m_msgs[i].msg_hdr;
+                hdr.msg_name = nullptr;
+                hdr.msg_namelen = 0;
+                hdr.msg_iov = &m_iov[i];
+                hdr.msg_iovlen = 1;
+                hdr.msg_control = m_cmsg[i].buffer;
+                hdr.msg_controllen = sizeof(m_cmsg[i].buffer);
+                hdr.msg_flags = 0;
+            }
+
+            int received = ::recvmmsg(socket.fd, m_msgs.data(), receive_batch, MSG_DONTWAIT, nullptr);
+            counters.syscalls++;
+            if (received <= 0) {
+                return;
+            }
+
+            int64_t fallback_ns = -1;
+            for (int i = 0; i < received; ++i) {
+                msghdr& hdr = m_msgs[i].msg_hdr;
+                if (hdr.msg_flags & MSG_TRUNC) {
+                    counters.datagrams++;
+                    counters.invalid++;
+                    continue;
+                }
+
+                int64_t arrival_ns = -1;
+                for (cmsghdr* cm = CMSG_FIRSTHDR(&hdr); cm; cm = CMSG_NXTHDR(&hdr, cm)) {
+                    if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_TIMESTAMPNS) {
+                        timespec ts;
+                        memcpy(&ts, CMSG_DATA(cm), sizeof(ts));
+                        arrival_ns = int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+                    }
+                }
+                if (arrival_ns < 0) {
+                    if (fallback_ns < 0) {
+                        timespec ts;
+                        clock_gettime(CLOCK_REALTIME, &ts);
+                        fallback_ns = int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+                    }
+                    arrival_ns = fallback_ns;
+                }
+
+                worker.on_datagram(static_cast<const uint8_t*>(m_iov[i].iov_base), int(m_msgs[i].msg_len), socket.port, arrival_ns);
+            }
+
+            if (received < receive_batch) {
+                return;
+            }
+        }
+    }
+
+    int m_epoll = -1;
+    std::vector<Socket> m_sockets;
+    std::vector<uint8_t> m_buffers;
+    std::vector<mmsghdr> m_msgs;
+    std::vector<iovec> m_iov;
+    std::vector<ControlBuffer> m_cmsg;
+};
+#endif
+
+class QtRtpReceiveBackend : public RtpReceiveBackend {
+
+public:
+    ~QtRtpReceiveBackend() override {
+        qDeleteAll(m_sockets);
+    }
+
+    bool open(const QHostAddress& address, quint16 first_port, int port_count) override {
+        for (int i = 0; i < port_count; ++i) {
+            QUdpSocket* socket = new QUdpSocket();
+            quint16 port = quint16(first_port + i);
+            if (!socket->bind(address, port)) {
+                qWarning() << "RTP-receiver: cannot bind port" << port << ":" << socket->errorString();
+                delete socket;
+                continue;
+            }
+            m_sockets.push_back(socket);
+            PollFd fd{};
+            fd.fd = PollSocket(socket->socketDescriptor());
+            fd.events = POLLIN;
+            m_fds.push_back(fd);
+        }
+        m_buffer.resize(2048);
+        return !m_sockets.isEmpty();
+    }
+
+    void receive(RtpReceiveWorker& worker, int timeout_ms) override {
+        //Without an event-loop the native descriptors of all ports are waited for at once
+#if defined(Q_OS_WIN)
+        int ready = WSAPoll(m_fds.data(), ULONG(m_fds.size()), timeout_ms);
+#else
+        int ready = ::poll(m_fds.data(), nfds_t(m_fds.size()), timeout_ms);
+#endif
+        worker.counters().syscalls++;
+        if (ready <= 0) {
+            return;
+        }
+
+        for (size_t i = 0; i < m_fds.size(); ++i) {
+            if (!(m_fds[i].revents & (POLLIN | POLLERR))) {
+                continue;
+            }
+            QUdpSocket* socket = m_sockets[int(i)];
+            while (socket->hasPendingDatagrams()) {
+                qint64 size = socket->readDatagram(m_buffer.data(), m_buffer.size());
+                //Stamped right after the read, the closest userspace gets to the arrival
+                int64_t arrival_ns = RtpClock::now_ns();
+                worker.counters().syscalls++;
+                if (size < 0) {
+                    break;
+                }
+                worker.on_datagram(reinterpret_cast<const uint8_t*>(m_buffer.constData()), int(size), socket->localPort(), arrival_ns);
+            }
+        }
+    }
+
+    const char* name() const override {
+        return "QUdpSocket";
+    }
+
+private:
+#if defined(Q_OS_WIN)
+    typedef WSAPOLLFD PollFd;
+    typedef SOCKET PollSocket;
+#else
+    typedef pollfd PollFd;
+    typedef int PollSocket;
+#endif
+
+    QVector<QUdpSocket*> m_sockets;
+    std::vector<PollFd> m_fds;
+    QByteArray m_buffer;
+};
+
+std::unique_ptr<RtpReceiveBackend> RtpReceiveBackend::create() {
+#ifdef Q_OS_LINUX
+    return std::unique_ptr<RtpReceiveBackend>(new MmsgRtpReceiveBackend());
+#else
+    return std::unique_ptr<RtpReceiveBackend>(new QtRtpReceiveBackend());
+#endif
+}
+
+RtpReceiveWorker::RtpReceiveWorker(const std::atomic<bool>& running, const QHostAddress& address, quint16 first_port, int port_count, StatsReporter reporter)
+    : m_running(running), m_address(address), m_first_port(first_port), m_port_count(port_count), m_reporter(std::move(reporter)) {}
+
+RtpReceiveWorker::~RtpReceiveWorker() = default;
+
+void RtpReceiveWorker::run() {
+    //Created on the worker-thread, so the sockets are owned by it
+    m_backend = RtpReceiveBackend::create();
+    if (!m_backend->open(m_address, m_first_port, m_port_count)) {
+        qWarning() << "RTP-receiver: no port of" << m_first_port << "+" << m_port_count << "could be opened";
+        m_backend.reset();
+        return;
+    }
+    qDebug() << "RTP-receiver on ports" << m_first_port << "-" << m_first_port + m_port_count - 1 << "with" << m_backend->name();
+
+    int64_t next_report_ns = RtpClock::now_ns() + stats_interval_ns;
+    while (m_running.load(std::memory_order_relaxed)) {
+        m_backend->receive(*this, receive_timeout_ms);
+
+        int64_t now_ns = RtpClock::now_ns();
+        if (now_ns >= next_report_ns) {
+            RtpReceiveWorker::report_stats();
+            next_report_ns = now_ns + stats_interval_ns;
+        }
+    }
+
+    RtpReceiveWorker::report_stats();
+    m_backend.reset();
+}
+
+void RtpReceiveWorker::on_datagram(const uint8_t* data, int size, uint16_t port, int64_t arrival_ns) {
+    m_counters.datagrams++;
+
+    //RTP version 2 with the fixed header, RTCP (rtcp-mux, RFC 5761: PT 192..223) is not analysed here
+    if (size < 12 || (data[0] >> 6) != 2 || (data[1] >= 192 && data[1] <= 223)) {
+        m_counters.invalid++;
+        return;
+    }
+
+    uint8_t payload_type = data[1] & 0x7F;
+    uint16_t sequence = uint16_t((data[2] << 8) | data[3]);
+    uint32_t timestamp = (uint32_t(data[4]) << 24) | (uint32_t(data[5]) << 16) | (uint32_t(data[6]) << 8) | data[7];
+    uint32_t ssrc = (uint32_t(data[8]) << 24) | (uint32_t(data[9]) << 16) | (uint32_t(data[10]) << 8) | data[11];
+
+    int index = m_table.find(ssrc, port);
+    if (index < 0) {
+        m_table.insert(ssrc, port, int(m_streams.size()));
+        m_streams.emplace_back();
+        m_streams.back().init(ssrc, port, payload_type, sequence, timestamp, arrival_ns);
+        return;
+    }
+    m_streams[size_t(index)].on_paket(sequence, timestamp, arrival_ns);
+}
+
+void RtpReceiveWorker::report_stats() {
+    QVector<RtpReceiveStats> stats;
+    for (RtpReceiveStream& stream : m_streams) {
+        if (stream.changed_since_report()) {
+            stats.push_back(stream.stats());
+            stream.mark_reported();
+        }
+    }
+
+    RtpReceiveCounters delta;
+    delta.datagrams = m_counters.datagrams - m_reported_counters.datagrams;
+    delta.syscalls = m_counters.syscalls - m_reported_counters.syscalls;
+    delta.invalid = m_counters.invalid - m_reported_counters.invalid;
+    m_reported_counters = m_counters;
+
+    if (m_reporter && (!stats.isEmpty() || delta.datagrams > 0)) {
+        m_reporter(stats, delta);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpreceiveworker.h/cpp:
+ *The RtpReceiveWorker-Class receives the RTP-pakets of a range of local
+ *ports on its own thread. On Linux all sockets of the range are watched
+ *by one epoll and read with recvmmsg straight into a fixed set of
+ *buffers (kernel-timestamps per paket), elsewhere QUdpSocket is used and
+ *the native descriptors of all ports are waited for with poll/WSAPoll.
+ *The pakets are demultiplexed by SSRC/port through the RtpSsrcTable and
+ *analysed in place, no paket is copied out of the receive-buffers.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPRECEIVEWORKER_H
+#define RTPRECEIVEWORKER_H
+
+#include "rtpreceivestream.h"
+#include "rtpssrctable.h"
+
+#include <QHostAddress>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+struct RtpReceiveCounters {
+    quint64 datagrams = 0;
+    quint64 syscalls = 0;
+    quint64 invalid = 0;        //no RTP (too short, version, RTCP) or truncated
+};
+
+class RtpReceiveBackend;
+
+class RtpReceiveWorker {
+
+public:
+    using StatsReporter = std::function<void(const QVector<RtpReceiveStats>& stats, const RtpReceiveCounters& delta)>;
+
+    RtpReceiveWorker(const std::atomic<bool>& running, const QHostAddress& address, quint16 first_port, int port_count, StatsReporter reporter);
+    ~RtpReceiveWorker();
+
+    void run();
+    //Called by the backend for every datagram, data points into its receive-buffer
+    void on_datagram(const uint8_t* data, int size, uint16_t port, int64_t arrival_ns);
+
+    RtpReceiveCounters& counters() { return m_counters; }
+
+private:
+    void report_stats();
+
+    const std::atomic<bool>& m_running;
+    QHostAddress m_address;
+    quint16 m_first_port;
+    int m_port_count;
+    StatsReporter m_reporter;
+    std::unique_ptr<RtpReceiveBackend> m_backend;
+
+    RtpSsrcTable m_table;
+    std::vector<RtpReceiveStream> m_streams;
+    RtpReceiveCounters m_counters;
+    RtpReceiveCounters m_reported_counters;
+};
+
+#endif // RTPRECEIVEWORKER_H
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpscenario.h/cpp:
+ *The RtpScenario-Class describes the impairments of the Advanced RTP-Flow
+ *(change SSRC/sequence, sequence-gap, pause or stop the stream). It is
+ *either collected from the ui (mainwindow.cpp) or loaded from a JSON-file.
+ *Before a stream is started the scenario is compiled into a timeline: a
+ *sorted list of RtpTimelineEvents with the ptime-slot ("tick") in which
+ *they fire and all random values already drawn. Drawn SSRCs are unique
+ *across all streams of the engine. The RtpStream only compares its current
+ *tick against the next event, so evaluating the scenario costs O(1) per
+ *paket. Overlapping pauses are counted, the stream resumes when the last
+ *one ended.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpscenario.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+bool RtpScenario::is_empty() const {
+    return start_ssrc.isEmpty() && start_sequence < 0 && actions.isEmpty();
+}
+
+uint64_t RtpScenario::to_ticks(const RtpTrigger& trigger, int ptime_ms) {
+    if (trigger.value <= 0.0) {
+        return 0;
+    }
+    if (trigger.in_pakets) {
+        return uint64_t(std::llround(trigger.value));
+    }
+    return uint64_t(std::llround(trigger.value * 1000.0 / ptime_ms));
+}
+
+uint32_t RtpScenario::unique_ssrc(QSet<uint32_t>& used_ssrcs) {
+    uint32_t ssrc = 0;
+    do {
+        ssrc = QRandomGenerator::global()->generate();
+    } while (used_ssrcs.contains(ssrc));
+    used_ssrcs.insert(ssrc);
+    return ssrc;
+}
+
+std::vector<RtpTimelineEvent> RtpScenario::compile(int ptime_ms, QSet<uint32_t>& used_ssrcs) const {
+    QRandomGenerator* random = QRandomGenerator::global();
+    std::vector<RtpTimelineEvent> timeline;
+
+    for (const RtpScenarioAction& action : actions) {
+        uint64_t tick = RtpScenario::to_ticks(action.at, ptime_ms);
+        switch (action.type) {
+        case RtpScenarioAction::ChangeSsrc:
+            timeline.push_back({tick, RtpTimelineEvent::SetSsrc, RtpScenario::unique_ssrc(used_ssrcs)});
+            if (action.also_sequence) {
+                timeline.push_back({tick, RtpTimelineEvent::SetSequence, random->generate() & 0xFFFF});
+            }
+            break;
+        case RtpScenarioAction::ChangeSequence:
+            if (action.sequence_gap > 0) {
+                timeline.push_back({tick, RtpTimelineEvent::SkipSequence, uint32_t(action.sequence_gap)});
+            } else {
+                timeline.push_back({tick, RtpTimelineEvent::SetSequence, random->generate() & 0xFFFF});
+            }
+            if (action.also_ssrc) {
+                timeline.push_back({tick, RtpTimelineEvent::SetSsrc, RtpScenario::unique_ssrc(used_ssrcs)});
+            }
+            break;
+        case RtpScenarioAction::Pause:
+            timeline.push_back({tick, RtpTimelineEvent::Pause, 0});
+            timeline.push_back({tick + RtpScenario::to_ticks(action.duration, ptime_ms), RtpTimelineEvent::Resume, 0});
+            break;
+        case RtpScenarioAction::Stop:
+            timeline.push_back({tick, RtpTimelineEvent::Stop, 0});
+            break;
+        }
+    }
+
+    std::stable_sort(timeline.begin(), timeline.end(), [](const RtpTimelineEvent& a, const RtpTimelineEvent& b) {
+        return a.tick < b.tick;
+    });
+    return timeline;
+}
+
+//Format of a scenario-file (JSON), all keys are optional:
+//{
+//  "start_ssrc": "0x11111111",
+//  "start_sequence": 1000,
+//  "events": [
+//    { "at": 250, "unit": "pakets", "action": "change_ssrc", "also_sequence": true },
+//    { "at": 5, "unit": "seconds", "action": "change_sequence", "gap": 20, "also_ssrc": false },
+//    { "at": 10, "action": "pause", "for": 2, "for_unit": "seconds" },
+//    { "at": 30, "action": "stop" }
+//  ]
+//}
+bool RtpScenario::load(const QString& path, RtpScenario& scenario) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open scenario:" << path;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (doc.isNull() || !doc.isObject()) {
+        qWarning() << "Invalid scenario" << path << ":" << error.errorString();
+        return false;
+    }
+
+    QJsonObject root = doc.object();
+    scenario = RtpScenario();
+    scenario.start_ssrc = root.value("start_ssrc").toString();
+    scenario.start_sequence = root.value("start_sequence").toInt(-1);
+
+    const QJsonArray events = root.value("events").toArray();
+    for (const QJsonValue& value : events) {
+        QJsonObject event = value.toObject();
+        RtpScenarioAction action;
+        action.at.value = event.value("at").toDouble();
+        action.at.in_pakets = event.value("unit").toString() == "pakets";
+
+        QString type = event.value("action").toString();
+        if (type == "change_ssrc") {
+            action.type = RtpScenarioAction::ChangeSsrc;
+            action.also_sequence = event.value("also_sequence").toBool();
+        } else if (type == "change_sequence") {
+            action.type = RtpScenarioAction::ChangeSequence;
+            action.also_ssrc = event.value("also_ssrc").toBool();
+            action.sequence_gap = event.value("gap").toInt();
+        } else if (type == "pause") {
+            action.type = RtpScenarioAction::Pause;
+            action.duration.value = event.value("for").toDouble();
+            action.duration.in_pakets = event.value("for_unit").toString() == "pakets";
+        } else if (type == "stop") {
+            action.type = RtpScenarioAction::Stop;
+        } else {
+            qWarning() << "Unknown scenario action:" << type;
+            return false;
+        }
+        scenario.actions.push_back(action);
+    }
+
+    return true;
+}
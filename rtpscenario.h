@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpscenario.h/cpp:
+ *The RtpScenario-Class describes the impairments of the Advanced RTP-Flow
+ *(change SSRC/sequence, sequence-gap, pause or stop the stream). It is
+ *either collected from the ui (mainwindow.cpp) or loaded from a JSON-file.
+ *Before a stream is started the scenario is compiled into a timeline: a
+ *sorted list of RtpTimelineEvents with the ptime-slot ("tick") in which
+ *they fire and all random values already drawn. Drawn SSRCs are unique
+ *across all streams of the engine. The RtpStream only compares its current
+ *tick against the next event, so evaluating the scenario costs O(1) per
+ *paket. Overlapping pauses are counted, the stream resumes when the last
+ *one ended.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPSCENARIO_H
+#define RTPSCENARIO_H
+
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <cstdint>
+#include <vector>
+
+struct RtpTrigger {
+    double value = 0.0;
+    bool in_pakets = false;     //false = seconds, true = pakets (ptime-slots)
+};
+
+struct RtpScenarioAction {
+    enum Type { ChangeSsrc, ChangeSequence, Pause, Stop };
+
+    Type type = ChangeSsrc;
+    RtpTrigger at;
+    bool also_ssrc = false;         //ChangeSequence: draw a new SSRC too
+    bool also_sequence = false;     //ChangeSsrc: draw a new random sequence too
+    int sequence_gap = 0;           //ChangeSequence: >0 skips this many numbers instead of a random jump
+    RtpTrigger duration;            //Pause: how long the stream is paused
+};
+
+struct RtpTimelineEvent {
+    enum Op : uint8_t { SetSsrc, SetSequence, SkipSequence, Pause, Resume, Stop };
+
+    uint64_t tick;
+    Op op;
+    uint32_t value;
+};
+
+class RtpScenario {
+
+public:
+    QString start_ssrc;
+    int start_sequence = -1;
+    QVector<RtpScenarioAction> actions;
+
+    bool is_empty() const;
+    //Random SSRCs are drawn until they are not in used_ssrcs and then added to it
+    std::vector<RtpTimelineEvent> compile(int ptime_ms, QSet<uint32_t>& used_ssrcs) const;
+
+    static bool load(const QString& path, RtpScenario& scenario);
+
+private:
+    static uint64_t to_ticks(const RtpTrigger& trigger, int ptime_ms);
+    static uint32_t unique_ssrc(QSet<uint32_t>& used_ssrcs);
+};
+
+#endif // RTPSCENARIO_H
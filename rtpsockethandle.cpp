@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpsockethandle.h/cpp:
+ *The RtpSocketHandle-Class holds a duplicate of a foreign UDP-socket (the
+ *RTP-socket of a PJSIP media-transport), so a RtpStream can send over the
+ *port announced in the SDP. The duplicate keeps the socket alive after
+ *PJSIP closed its descriptor and is closed with the last stream using it.
+ *Duplicating uses fcntl on unix-like systems and WSADuplicateSocket on
+ *Windows. socket_address()/send_to() let a backend without native batching
+ *(the QtRtpTransport) send over such a socket, too.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpsockethandle.h"
+
+#include <QDebug>
+
+#if defined(Q_OS_WIN)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+RtpSocketHandle::~RtpSocketHandle() {
+#if defined(Q_OS_WIN)
+    ::closesocket(SOCKET(m_descriptor));
+#elif defined(Q_OS_UNIX)
+    ::close(int(m_descriptor));
+#endif
+}
+
+bool RtpSocketHandle::supported() {
+#if defined(Q_OS_WIN) || defined(Q_OS_UNIX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<const RtpSocketHandle> RtpSocketHandle::duplicate(qintptr descriptor) {
+#if defined(Q_OS_WIN)
+    //A duplicate for the own process is a second SOCKET on the same endpoint, closed independently
+    WSAPROTOCOL_INFOW info;
+    if (WSADuplicateSocketW(SOCKET(descriptor), GetCurrentProcessId(), &info) != 0) {
+        qWarning() << "RTP-socket" << descriptor << "could not be duplicated, error" << WSAGetLastError();
+        return nullptr;
+    }
+    SOCKET copy = WSASocketW(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, &info, 0,
+                             WSA_FLAG_OVERLAPPED | WSA_FLAG_NO_HANDLE_INHERIT);
+    if (copy == INVALID_SOCKET) {
+        qWarning() << "RTP-socket" << descriptor << "could not be duplicated, error" << WSAGetLastError();
+        return nullptr;
+    }
+    return std::shared_ptr<const RtpSocketHandle>(new RtpSocketHandle(qintptr(copy)));
+#elif defined(Q_OS_UNIX)
+    int copy = ::fcntl(int(descriptor), F_DUPFD_CLOEXEC, 0);
+    if (copy < 0) {
+        qWarning() << "RTP-socket" << descriptor << "could not be duplicated";
+        return nullptr;
+    }
+    return std::shared_ptr<const RtpSocketHandle>(new RtpSocketHandle(copy));
+#else
+    Q_UNUSED(descriptor);
+    return nullptr;
+#endif
+}
+
+QByteArray RtpSocketHandle::socket_address(qintptr descriptor, const QHostAddress& address, quint16 port) {
+#if defined(Q_OS_WIN) || defined(Q_OS_UNIX)
+    //The bound address of the socket decides how the destination has to look like
+    sockaddr_storage local{};
+    socklen_t local_len = sizeof(local);
+#if defined(Q_OS_WIN)
+    SOCKET fd = SOCKET(descriptor);
+#else
+    int fd = int(descriptor);
+#endif
+    if (address.isNull() || getsockname(fd, reinterpret_cast<sockaddr*>(&local), &local_len) != 0) {
+        return QByteArray();
+    }
+
+    if (local.ss_family == AF_INET6) {
+        sockaddr_in6 sin6{};
+        Q_IPV6ADDR ip6 = address.toIPv6Address();
+        sin6.sin6_family = AF_INET6;
+        sin6.sin6_port = htons(port);
+        memcpy(&sin6.sin6_addr, &ip6, sizeof(ip6));
+        return QByteArray(reinterpret_cast<const char*>(&sin6), int(sizeof(sin6)));
+    }
+    if (local.ss_family == AF_INET && address.protocol() == QAbstractSocket::IPv4Protocol) {
+        sockaddr_in sin{};
+        sin.sin_family = AF_INET;
+        sin.sin_port = htons(port);
+        sin.sin_addr.s_addr = htonl(address.toIPv4Address());
+        return QByteArray(reinterpret_cast<const char*>(&sin), int(sizeof(sin)));
+    }
+    return QByteArray();
+#else
+    Q_UNUSED(descriptor);
+    Q_UNUSED(address);
+    Q_UNUSED(port);
+    return QByteArray();
+#endif
+}
+
+bool RtpSocketHandle::send_to(qintptr descriptor, const QByteArray& socket_address, const char* data, int size) {
+    const sockaddr* to = reinterpret_cast<const sockaddr*>(socket_address.constData());
+#if defined(Q_OS_WIN)
+    return ::sendto(SOCKET(descriptor), data, size, 0, to, socket_address.size()) != SOCKET_ERROR;
+#elif defined(Q_OS_UNIX)
+    return ::sendto(int(descriptor), data, size_t(size), 0, to, socklen_t(socket_address.size())) >= 0;
+#else
+    Q_UNUSED(descriptor);
+    Q_UNUSED(to);
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+    return false;
+#endif
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpsockethandle.h/cpp:
+ *The RtpSocketHandle-Class holds a duplicate of a foreign UDP-socket (the
+ *RTP-socket of a PJSIP media-transport), so a RtpStream can send over the
+ *port announced in the SDP. The duplicate keeps the socket alive after
+ *PJSIP closed its descriptor and is closed with the last stream using it.
+ *Duplicating uses fcntl on unix-like systems and WSADuplicateSocket on
+ *Windows. socket_address()/send_to() let a backend without native batching
+ *(the QtRtpTransport) send over such a socket, too.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPSOCKETHANDLE_H
+#define RTPSOCKETHANDLE_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QtGlobal>
+
+#include <memory>
+
+class RtpSocketHandle {
+
+public:
+    ~RtpSocketHandle();
+
+    RtpSocketHandle(const RtpSocketHandle&) = delete;
+    RtpSocketHandle& operator=(const RtpSocketHandle&) = delete;
+
+    qintptr descriptor() const { return m_descriptor; }
+
+    //false if this platform can not share a socket, decided before a call is made
+    static bool supported();
+    //nullptr if the descriptor can not be duplicated
+    static std::shared_ptr<const RtpSocketHandle> duplicate(qintptr descriptor);
+
+    //Native address of address:port in the family of the socket, empty if not reachable over it
+    static QByteArray socket_address(qintptr descriptor, const QHostAddress& address, quint16 port);
+    static bool send_to(qintptr descriptor, const QByteArray& socket_address, const char* data, int size);
+
+private:
+    explicit RtpSocketHandle(qintptr descriptor) : m_descriptor(descriptor) {}
+
+    qintptr m_descriptor;
+};
+
+#endif // RTPSOCKETHANDLE_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpssrctable.h/cpp:
+ *The RtpSsrcTable-Class maps SSRC and local port of a received RTP-paket
+ *to the index of its stream. It is a flat open-addressing hash-table
+ *(linear probing, power-of-two size) so the lookup per paket is one hash
+ *and usually one cache-line, also with 10k+ streams.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "rtpssrctable.h"
+
+RtpSsrcTable::RtpSsrcTable(int capacity) {
+    uint32_t size = 16;
+    while (size < uint32_t(capacity) * 2) {
+        size <<= 1;
+    }
+    m_entries.assign(size, Entry{0, -1});
+    m_mask = size - 1;
+}
+
+void RtpSsrcTable::insert(uint32_t ssrc, uint16_t port, int index) {
+    //Load-factor below 50%, so a probe-sequence stays short
+    if (uint32_t(m_size + 1) * 2 > m_mask + 1) {
+        RtpSsrcTable::grow();
+    }
+
+    uint64_t key = make_key(ssrc, port);
+    for (uint32_t slot = hash(key) & m_mask;; slot = (slot + 1) & m_mask) {
+        Entry& entry = m_entries[slot];
+        if (entry.index < 0) {
+            entry = {key, index};
+            m_size++;
+            return;
+        }
+        if (entry.key == key) {
+            entry.index = index;
+            return;
+        }
+    }
+}
+
+int RtpSsrcTable::size() const {
+    return m_size;
+}
+
+void RtpSsrcTable::clear() {
+    m_entries.assign(m_entries.size(), Entry{0, -1});
+    m_size = 0;
+}
+
+void RtpSsrcTable::grow() {
+    std::vector<Entry> old;
+    old.swap(m_entries);
+    m_entries.assign(old.size() * 2, Entry{0, -1});
+    m_mask = uint32_t(m_entries.size()) - 1;
+
+    for (const Entry& entry : old) {
+        if (entry.index < 0) {
+            continue;
+        }
+        for (uint32_t slot = hash(entry.key) & m_mask;; slot = (slot + 1) & m_mask) {
+            if (m_entries[slot].index < 0) {
+                m_entries[slot] = entry;
+                break;
+            }
+        }
+    }
+}
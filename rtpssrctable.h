@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpssrctable.h/cpp:
+ *The RtpSsrcTable-Class maps SSRC and local port of a received RTP-paket
+ *to the index of its stream. It is a flat open-addressing hash-table
+ *(linear probing, power-of-two size) so the lookup per paket is one hash
+ *and usually one cache-line, also with 10k+ streams.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPSSRCTABLE_H
+#define RTPSSRCTABLE_H
+
+#include <cstdint>
+#include <vector>
+
+class RtpSsrcTable {
+
+public:
+    explicit RtpSsrcTable(int capacity = 1024);
+
+    //Returns the stream-index or -1
+    int find(uint32_t ssrc, uint16_t port) const;
+    void insert(uint32_t ssrc, uint16_t port, int index);
+    int size() const;
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t key;
+        int32_t index;      //-1 = empty
+    };
+
+    static uint64_t make_key(uint32_t ssrc, uint16_t port);
+    static uint32_t hash(uint64_t key);
+    void grow();
+
+    std::vector<Entry> m_entries;
+    uint32_t m_mask;
+    int m_size = 0;
+};
+
+inline uint64_t RtpSsrcTable::make_key(uint32_t ssrc, uint16_t port) {
+    return (uint64_t(port) << 32) | ssrc;
+}
+
+inline uint32_t RtpSsrcTable::hash(uint64_t key) {
+    //Finalizer of MurmurHash3, SSRCs are random but the ports are not
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return uint32_t(key);
+}
+
+inline int RtpSsrcTable::find(uint32_t ssrc, uint16_t port) const {
+    uint64_t key = make_key(ssrc, port);
+    for (uint32_t slot = hash(key) & m_mask;; slot = (slot + 1) & m_mask) {
+        const Entry& entry = m_entries[slot];
+        if (entry.index < 0) {
+            return -1;
+        }
+        if (entry.key == key) {
+            return entry.index;
+        }
+    }
+}
+
+#endif // RTPSSRCTABLE_H
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpstream.h/cpp:
+ *The RtpStream-Class holds the complete state of one generated RTP-stream:
+ *SSRC, sequence-number, RTP-timestamp, paket-builder and statistics.
+ *As recommended by RFC 3550 the initial SSRC (if not configured), sequence
+ *and timestamp are random. A RtpStream is created by the RtpEngine and then
+ *handed over to exactly one RtpWorker, which is the only thread advancing
+ *it - so there is no shared mutable state and no locking on the hot path.
+ *If the stream has a RtpScenario, its compiled timeline is evaluated here
+ *once per ptime-slot with a single comparison against the next event.
+ *A fired RtpDtmfPlan is handled the same way: in the slots of an event the
+ *telephone-event paket is sent instead of the voice, in the sequence- and
+ *timestamp-space of the stream.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpstream.h"
+
+#include <QRandomGenerator>
+#include <QDebug>
+
+#include <cmath>
+
+bool RtpStream::init(const RtpStreamConfig& config, uint32_t ssrc, quint32 stream_id, QSet<uint32_t>& used_ssrcs) {
+    if (!m_builder.init(config.payload_type, ssrc, config.ptime_ms)) {
+        return false;
+    }
+
+    m_config = config;
+    m_ptime_ns = int64_t(config.ptime_ms) * 1000000LL;
+
+    //RFC 3550 5.1: initial sequence-number and timestamp SHOULD be random
+    QRandomGenerator* random = QRandomGenerator::global();
+    m_sequence = config.start_sequence >= 0 ? uint16_t(config.start_sequence) : uint16_t(random->generate());
+    m_timestamp = random->generate();
+
+    m_stats = RtpStreamStats();
+    m_stats.stream_id = stream_id;
+    m_stats.ssrc = ssrc;
+
+    m_timeline.clear();
+    if (config.scenario) {
+        m_timeline = config.scenario->compile(config.ptime_ms, used_ssrcs);
+    }
+    m_next_event = 0;
+    m_next_event_tick = m_timeline.empty() ? std::numeric_limits<uint64_t>::max() : m_timeline.front().tick;
+    m_tick = 0;
+    m_ssrc_dirty_slots = 0;
+    m_pause_depth = 0;
+    m_stopped = false;
+
+    m_dtmf_plan.reset();
+    m_dtmf = nullptr;
+    m_dtmf_next = 0;
+    m_next_dtmf_tick = std::numeric_limits<uint64_t>::max();
+    m_pt_dirty_slots = 0;
+    if (config.event_payload_type > 127) {
+        qWarning() << "Invalid telephone-event payload type:" << config.event_payload_type;
+        return false;
+    }
+
+    //The CNAME stays the same over SSRC-changes, so the far end can correlate them
+    m_cname = QString("stream%1@rtp-generator").arg(stream_id).toUtf8();
+    m_slot_deadline_ns = 0;
+    m_slot_timestamp = m_timestamp;
+    m_sender_packets = 0;
+    m_sender_octets = 0;
+    m_reported_packets = 0;
+
+    m_audio_frames = nullptr;
+    m_frame_count = 0;
+    m_frame = 0;
+    if (config.audio) {
+        const std::vector<uint8_t>* frames = config.audio->frames(m_builder.payload_type());
+        if (frames && frames->size() >= size_t(m_builder.payload_size())) {
+            m_audio_frames = frames->data();
+            m_frame_count = frames->size() / size_t(m_builder.payload_size());
+        } else {
+            qWarning() << "Audio file too short for ptime, sending filler-payload";
+        }
+    }
+    return true;
+}
+
+uint32_t RtpStream::random_ssrc() {
+    return QRandomGenerator::global()->generate();
+}
+
+bool RtpStream::parse_ssrc(const QString& text, uint32_t& ssrc) {
+    bool ok = false;
+    ssrc = text.trimmed().toUInt(&ok, 0);
+    return ok;
+}
+
+void RtpStream::apply_events() {
+    while (m_next_event < m_timeline.size() && m_timeline[m_next_event].tick <= m_tick) {
+        const RtpTimelineEvent& event = m_timeline[m_next_event++];
+        switch (event.op) {
+        case RtpTimelineEvent::SetSsrc:
+            m_builder.set_ssrc(event.value);
+            m_stats.ssrc = event.value;
+            m_ssrc_dirty_slots = RtpPacketPool::ring_depth;
+            m_sender_packets = 0;
+            m_sender_octets = 0;
+            m_reported_packets = 0;
+            break;
+        case RtpTimelineEvent::SetSequence:
+            m_sequence = uint16_t(event.value);
+            break;
+        case RtpTimelineEvent::SkipSequence:
+            m_sequence = uint16_t(m_sequence + event.value);
+            break;
+        case RtpTimelineEvent::Pause:
+            m_pause_depth++;
+            break;
+        case RtpTimelineEvent::Resume:
+            //Overlapping pauses: the stream only sends again when the last one ended
+            if (m_pause_depth > 0 && --m_pause_depth == 0) {
+                //The pause is no send-jitter
+                m_last_sent_ns = 0;
+            }
+            break;
+        case RtpTimelineEvent::Stop:
+            m_stopped = true;
+            break;
+        }
+    }
+
+    m_next_event_tick = m_next_event < m_timeline.size() ? m_timeline[m_next_event].tick
+                                                        : std::numeric_limits<uint64_t>::max();
+}
+
+bool RtpStream::start_dtmf(const std::shared_ptr<const RtpDtmfPlan>& plan) {
+    if (m_config.event_payload_type < 0 || m_dtmf || m_stopped || !plan) {
+        return false;
+    }
+    const std::vector<RtpDtmfPaket>* pakets = plan->pakets(m_config.ptime_ms);
+    if (!pakets || pakets->empty()) {
+        return false;
+    }
+
+    m_dtmf_plan = plan;
+    m_dtmf = pakets;
+    m_dtmf_next = 0;
+    m_dtmf_start_tick = m_tick;
+    m_next_dtmf_tick = m_tick + pakets->front().tick;
+    return true;
+}
+
+const RtpDtmfPaket* RtpStream::next_dtmf() {
+    const RtpDtmfPaket* paket = &(*m_dtmf)[m_dtmf_next++];
+    if (paket->marker) {
+        m_stats.dtmf_events++;
+    }
+    if (m_dtmf_next < m_dtmf->size()) {
+        m_next_dtmf_tick = m_dtmf_start_tick + (*m_dtmf)[m_dtmf_next].tick;
+    } else {
+        //The plan stays referenced until the next sequence, the returned paket points into it
+        m_dtmf = nullptr;
+        m_next_dtmf_tick = std::numeric_limits<uint64_t>::max();
+    }
+    return paket;
+}
+
+void RtpStream::record_send(int64_t deadline_ns, int64_t now_ns, int payload_size) {
+    double lateness_us = (now_ns - deadline_ns) / 1000.0;
+    m_lateness_sum_us += lateness_us;
+    m_stats.max_lateness_us = qMax(m_stats.max_lateness_us, lateness_us);
+    if (m_last_sent_ns != 0) {
+        double deviation_us = std::fabs((now_ns - m_last_sent_ns - m_ptime_ns) / 1000.0);
+        m_stats.jitter_us += (deviation_us - m_stats.jitter_us) / 16.0;
+    }
+    m_last_sent_ns = now_ns;
+    m_stats.packets_sent++;
+    m_stats.mean_lateness_us = m_lateness_sum_us / m_stats.packets_sent;
+    m_sender_packets++;
+    m_sender_octets += uint32_t(payload_size);
+}
+
+int RtpStream::write_rtcp(uint8_t* out, int64_t now_ns, int64_t unix_ns, bool bye) {
+    uint32_t ssrc = m_builder.ssrc();
+    int size = 0;
+    if (m_sender_packets != m_reported_packets) {
+        //RTP-timestamp of "now", extrapolated from the last slot with the nominal clock-rate
+        int64_t elapsed_ns = qMax<int64_t>(0, now_ns - m_slot_deadline_ns);
+        uint32_t rtp_timestamp = m_slot_timestamp + uint32_t(elapsed_ns * int64_t(m_builder.timestamp_step()) / m_ptime_ns);
+        size = RtcpPacket::write_sender_report(out, ssrc, RtcpPacket::ntp_timestamp(unix_ns), rtp_timestamp,
+                                               m_sender_packets, m_sender_octets);
+        m_reported_packets = m_sender_packets;
+    } else {
+        //Nothing sent since the last report (paused/stopped): RR keeps the session alive
+        size = RtcpPacket::write_receiver_report(out, ssrc);
+    }
+    size += RtcpPacket::write_sdes_cname(out + size, ssrc, m_cname);
+    if (bye) {
+        size += RtcpPacket::write_bye(out + size, ssrc);
+    }
+    m_stats.rtcp_sent++;
+    return size;
+}
+
+void RtpStream::record_report(const RtcpReportBlock& block, double rtt_ms) {
+    m_stats.rtcp_received++;
+    if (rtt_ms >= 0.0) {
+        m_stats.rtt_ms = rtt_ms;
+    }
+    m_stats.remote_loss_percent = block.fraction_lost * 100.0 / 256.0;
+    m_stats.remote_lost = block.cumulative_lost;
+    m_stats.remote_jitter_ms = double(block.jitter) * (m_ptime_ns / 1000000.0) / m_builder.timestamp_step();
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpstream.h/cpp:
+ *The RtpStream-Class holds the complete state of one generated RTP-stream:
+ *SSRC, sequence-number, RTP-timestamp, paket-builder and statistics.
+ *As recommended by RFC 3550 the initial SSRC (if not configured), sequence
+ *and timestamp are random. A RtpStream is created by the RtpEngine and then
+ *handed over to exactly one RtpWorker, which is the only thread advancing
+ *it - so there is no shared mutable state and no locking on the hot path.
+ *If the stream has a RtpScenario, its compiled timeline is evaluated here
+ *once per ptime-slot with a single comparison against the next event.
+ *A fired RtpDtmfPlan is handled the same way: in the slots of an event the
+ *telephone-event paket is sent instead of the voice, in the sequence- and
+ *timestamp-space of the stream.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPSTREAM_H
+#define RTPSTREAM_H
+
+#include "rtcppacket.h"
+#include "rtpdtmf.h"
+#include "rtpengine.h"
+#include "rtppacketbuilder.h"
+#include "rtpscenario.h"
+
+#include <QByteArray>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class RtpStream {
+
+public:
+    //used_ssrcs are the SSRCs of all streams of the engine, the scenario draws its SSRCs outside of them
+    bool init(const RtpStreamConfig& config, uint32_t ssrc, quint32 stream_id, QSet<uint32_t>& used_ssrcs);
+
+    static uint32_t random_ssrc();
+    static bool parse_ssrc(const QString& text, uint32_t& ssrc);
+
+    const RtpStreamConfig& config() const { return m_config; }
+    const RtpPacketBuilder& builder() const { return m_builder; }
+    const RtpStreamStats& stats() const { return m_stats; }
+    uint32_t ssrc() const { return m_builder.ssrc(); }
+    int64_t ptime_ns() const { return m_ptime_ns; }
+    uint16_t sequence() const { return m_sequence; }
+    uint32_t timestamp() const { return m_timestamp; }
+
+    int destination() const { return m_destination; }
+    void set_destination(int destination) { m_destination = destination; }
+    int rtcp_destination() const { return m_rtcp_destination; }
+    void set_rtcp_destination(int destination) { m_rtcp_destination = destination; }
+
+    bool finished() const {
+        return m_stopped || (m_config.packet_count > 0 && m_stats.packets_sent >= m_config.packet_count);
+    }
+
+    bool has_audio() const { return m_audio_frames != nullptr; }
+
+    //Starts a sequence with the next ptime-slot, false if the stream has no
+    //telephone-event payload-type, no pakets for its ptime or a sequence is still running
+    bool start_dtmf(const std::shared_ptr<const RtpDtmfPlan>& plan);
+
+    //Hot path, only called from the owning RtpWorker once per ptime-slot.
+    //Returns nullptr if no paket is sent in this slot (scenario pause/stop).
+    //With audio or DTMF the returned paket is only the RTP-header and payload
+    //points into the shared frame table of the RtpAudioAsset or the RtpDtmfPlan.
+    inline uint8_t* next_paket(RtpPacketPool& pool, int index, const uint8_t*& payload, int& payload_size) {
+        if (m_tick >= m_next_event_tick) {
+            RtpStream::apply_events();
+        }
+        const RtpDtmfPaket* dtmf = nullptr;
+        if (m_tick >= m_next_dtmf_tick) {
+            dtmf = RtpStream::next_dtmf();
+        }
+        m_tick++;
+
+        if (m_pause_depth > 0 || m_stopped) {
+            //The RTP-clock keeps running while the stream is silent
+            if (dtmf && dtmf->marker) {
+                m_dtmf_timestamp = m_timestamp;
+            }
+            m_timestamp += m_builder.timestamp_step();
+            RtpStream::next_frame();
+            return nullptr;
+        }
+
+        uint8_t* paket = pool.slot(index, m_stats.packets_sent);
+        if (m_ssrc_dirty_slots > 0) {
+            //After a SSRC-change every ring-slot gets the new SSRC once
+            RtpPacketBuilder::patch_ssrc(paket, m_builder.ssrc());
+            m_ssrc_dirty_slots--;
+        }
+        if (dtmf) {
+            //All pakets of one event carry the timestamp of its first slot (RFC 4733 2.5.1.2)
+            if (dtmf->marker) {
+                m_dtmf_timestamp = m_timestamp;
+            }
+            RtpPacketBuilder::patch(paket, m_sequence++, m_dtmf_timestamp);
+            paket[1] = uint8_t((dtmf->marker ? 0x80 : 0x00) | m_config.event_payload_type);
+            m_pt_dirty_slots = RtpPacketPool::ring_depth;
+            payload = dtmf->payload;
+            payload_size = RtpDtmfSequence::payload_size;
+            //The voice is replaced, not delayed
+            m_timestamp += m_builder.timestamp_step();
+            RtpStream::next_frame();
+            return paket;
+        }
+
+        RtpPacketBuilder::patch(paket, m_sequence++, m_timestamp);
+        if (m_pt_dirty_slots > 0) {
+            //After DTMF every ring-slot gets the voice payload-type back once
+            paket[1] = m_builder.payload_type() & 0x7F;
+            m_pt_dirty_slots--;
+        }
+        m_timestamp += m_builder.timestamp_step();
+        payload_size = m_builder.payload_size();
+        if (m_audio_frames) {
+            payload = m_audio_frames + m_frame * size_t(m_builder.payload_size());
+            RtpStream::next_frame();
+        }
+        return paket;
+    }
+
+    void record_send(int64_t deadline_ns, int64_t now_ns, int payload_size);
+    void record_resync() { m_stats.resyncs++; }
+
+    //Reference for the NTP/RTP-timestamp mapping of the SR, called for every ptime-slot
+    //(also silent ones) before next_paket(): the slot's timestamp belongs to its deadline
+    inline void record_slot(int64_t deadline_ns) {
+        m_slot_deadline_ns = deadline_ns;
+        m_slot_timestamp = m_timestamp;
+    }
+
+    //Renders the compound RTCP-paket (SR or RR, SDES, optional BYE) for the instant
+    //now_ns on the RtpClock which is unix_ns on the wallclock
+    int write_rtcp(uint8_t* out, int64_t now_ns, int64_t unix_ns, bool bye);
+    void record_report(const RtcpReportBlock& block, double rtt_ms);
+
+private:
+    void apply_events();
+    const RtpDtmfPaket* next_dtmf();
+
+    inline void next_frame() {
+        //The audio loops endless
+        if (++m_frame == m_frame_count) {
+            m_frame = 0;
+        }
+    }
+
+    RtpStreamConfig m_config;
+    RtpPacketBuilder m_builder;
+    int m_destination = -1;
+    int m_rtcp_destination = -1;
+    uint16_t m_sequence = 0;
+    uint32_t m_timestamp = 0;
+    int64_t m_ptime_ns = 0;
+    int64_t m_last_sent_ns = 0;
+    double m_lateness_sum_us = 0.0;
+    RtpStreamStats m_stats;
+
+    std::vector<RtpTimelineEvent> m_timeline;
+    size_t m_next_event = 0;
+    uint64_t m_next_event_tick = std::numeric_limits<uint64_t>::max();
+    uint64_t m_tick = 0;
+    int m_ssrc_dirty_slots = 0;
+
+    const uint8_t* m_audio_frames = nullptr;
+    size_t m_frame_count = 0;
+    size_t m_frame = 0;
+    int m_pause_depth = 0;      //overlapping pauses of the scenario, paused while > 0
+    bool m_stopped = false;
+
+    //Running DTMF-sequence, the plan is shared with all other streams it was fired on
+    std::shared_ptr<const RtpDtmfPlan> m_dtmf_plan;
+    const std::vector<RtpDtmfPaket>* m_dtmf = nullptr;
+    size_t m_dtmf_next = 0;
+    uint64_t m_dtmf_start_tick = 0;
+    uint64_t m_next_dtmf_tick = std::numeric_limits<uint64_t>::max();
+    uint32_t m_dtmf_timestamp = 0;
+    int m_pt_dirty_slots = 0;
+
+    //RTCP, the sender counters belong to the current SSRC
+    QByteArray m_cname;
+    int64_t m_slot_deadline_ns = 0;
+    uint32_t m_slot_timestamp = 0;
+    uint32_t m_sender_packets = 0;
+    uint32_t m_sender_octets = 0;
+    uint32_t m_reported_packets = 0;
+};
+
+#endif // RTPSTREAM_H
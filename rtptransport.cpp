@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtptransport.h/cpp:
+ *The RtpTransport-Class is the send-backend of a RtpWorker. The worker
+ *queues every paket which is due in one scheduling tick and flushes them
+ *together at the end of the tick.
+ *On Linux the MmsgRtpTransport hands the complete tick to the kernel with
+ *one sendmmsg-call and coalesces consecutive pakets with the same size and
+ *destination into one UDP-GSO (UDP_SEGMENT) message where the kernel
+ *supports it. On all other platforms (or if the native socket can not be
+ *created) the QtRtpTransport sends every paket with QUdpSocket.
+ *A paket is queued as header plus optional payload, so payloads can be
+ *sent directly out of a shared RtpAudioAsset without copying them.
+ *Both count datagrams and syscalls, so the saved syscalls are visible.
+ *receive() reads what comes back to the socket (RTCP-reports) without
+ *blocking, on Linux with the receive-time of the kernel.
+ *A destination can be bound to a foreign socket (the media-socket of a
+ *SIP-call), consecutive pakets over the same socket are still batched.
+ *The QtRtpTransport sends over a foreign socket with plain sendto().
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtptransport.h"
+#include "rtpclock.h"
+#include "rtpsockethandle.h"
+
+#include <QUdpSocket>
+#include <QDebug>
+
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+//Kernel-limits: UIO_MAXIOV entries per call, UDP_MAX_SEGMENTS per GSO-message
+const int max_batch = 1024;
+const int max_gso_segments = 64;
+const int max_gso_bytes = 65000;
+const int send_buffer_size = 4 * 1024 * 1024;
+const int max_receive_batch = 64;
+
+class MmsgRtpTransport : public RtpTransport {
+
+public:
+    ~MmsgRtpTransport() override {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    bool open() {
+        //One dual-stack socket serves IPv4 (as v4-mapped) and IPv6 destinations
+        m_fd = ::socket(AF_INET6, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (m_fd >= 0) {
+            int v6only = 0;
+            setsockopt(m_fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only));
+            m_family = AF_INET6;
+        } else {
+            m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            m_family = AF_INET;
+        }
+        if (m_fd < 0) {
+            return false;
+        }
+
+        int buffer = send_buffer_size;
+        setsockopt(m_fd, SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+        //Only costs something for received datagrams, the RTT of RTCP needs the exact arrival
+        int timestamps = 1;
+        setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPNS, &timestamps, sizeof(timestamps));
+
+        //getsockopt(UDP_SEGMENT) only succeeds on kernels with UDP-GSO support
+        int gso_size = 0;
+        socklen_t len = sizeof(gso_size);
+        m_gso = getsockopt(m_fd, SOL_UDP, UDP_SEGMENT, &gso_size, &len) == 0;
+
+        m_msgs.resize(max_batch);
+        m_info.resize(max_batch);
+        m_iov.resize(max_batch);
+        m_cmsg.resize(max_batch);
+        return true;
+    }
+
+    int add_destination(const QHostAddress& address, quint16 port, qintptr socket = -1) override {
+        int fd = m_fd;
+        int family = m_family;
+        if (socket >= 0) {
+            //The foreign socket decides how the address has to look like
+            fd = int(socket);
+            socklen_t family_len = sizeof(family);
+            if (getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &family, &family_len) != 0) {
+                return -1;
+            }
+        }
+
+        sockaddr_storage storage{};
+        socklen_t len = 0;
+        bool ok = false;
+        if (family == AF_INET6) {
+            Q_IPV6ADDR ip6 = address.toIPv6Address();
+            sockaddr_in6* sin6 = reinterpret_cast<sockaddr_in6*>(&storage);
+            sin6->sin6_family = AF_INET6;
+            sin6->sin6_port = htons(port);
+            memcpy(&sin6->sin6_addr, &ip6, sizeof(ip6));
+            len = sizeof(sockaddr_in6);
+            ok = !address.isNull();
+        } else if (address.protocol() == QAbstractSocket::IPv4Protocol) {
+            sockaddr_in* sin = reinterpret_cast<sockaddr_in*>(&storage);
+            sin->sin_family = AF_INET;
+            sin->sin_port = htons(port);
+            sin->sin_addr.s_addr = htonl(address.toIPv4Address());
+            len = sizeof(sockaddr_in);
+            ok = true;
+        }
+        if (!ok) {
+            return -1;
+        }
+
+        m_destinations.push_back({storage, len, fd});
+        return int(m_destinations.size()) - 1;
+    }
+
+    void queue(const uint8_t* header, int header_size, const uint8_t* payload, int payload_size, int destination) override {
+        if (destination < 0) {
+            m_stats.dropped++;
+            return;
+        }
+        //One sendmmsg-call goes over one socket
+        int fd = m_destinations[destination].fd;
+        if (m_iov_count + 2 > max_batch || m_msg_count == max_batch || (m_msg_count > 0 && fd != m_batch_fd)) {
+            MmsgRtpTransport::flush();
+        }
+        m_batch_fd = fd;
+
+        int iov_needed = payload ? 2 : 1;
+        int size = header_size + payload_size;
+        iovec* iov = &m_iov[m_iov_count];
+        iov[0].iov_base = const_cast<uint8_t*>(header);
+        iov[0].iov_len = size_t(header_size);
+        if (payload) {
+            iov[1].iov_base = const_cast<uint8_t*>(payload);
+            iov[1].iov_len = size_t(payload_size);
+        }
+
+        Message* last = m_msg_count > 0 ? &m_info[m_msg_count - 1] : nullptr;
+        if (m_gso && last && m_last_destination == destination && m_last_size == size && last->iov_per_segment == iov_needed
+            && last->segments < max_gso_segments && (last->segments + 1) * size <= max_gso_bytes) {
+            //Same size and destination as the previous paket: append as next GSO-segment
+            if (last->segments == 1) {
+                MmsgRtpTransport::set_segment_size(m_msg_count - 1, size);
+            }
+            last->segments++;
+            m_msgs[m_msg_count - 1].msg_hdr.msg_iovlen += size_t(iov_needed);
+        } else {
+            msghdr& hdr = m_msgs[m_msg_count].msg_hdr;
+            hdr.msg_name = &m_destinations[destination].address;
+            hdr.msg_namelen = m_destinations[destination].length;
+            hdr.msg_iov = iov;
+            hdr.msg_iovlen = size_t(iov_needed);
+            hdr.msg_control = nullptr;
+            hdr.msg_controllen = 0;
+            hdr.msg_flags = 0;
+            m_info[m_msg_count] = {1, iov_needed};
+            m_msg_count++;
+            m_last_destination = destination;
+            m_last_size = size;
+        }
+
+        m_iov_count += iov_needed;
+        m_stats.datagrams++;
+    }
+
+    void flush() override {
+        int sent = 0;
+        while (sent < m_msg_count) {
+            int result = ::sendmmsg(m_batch_fd, &m_msgs[sent], unsigned(m_msg_count - sent), 0);
+            m_stats.syscalls++;
+            if (result > 0) {
+                sent += result;
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (m_info[sent].segments > 1 && (errno == EIO || errno == EINVAL)) {
+                //The route/NIC refused GSO: never try it again and send the segments one by one
+                qWarning() << "UDP-GSO rejected by the kernel, falling back to plain sendmmsg";
+                m_gso = false;
+                MmsgRtpTransport::send_segments(sent);
+            } else {
+                m_stats.dropped += quint64(m_info[sent].segments);
+            }
+            sent++;
+        }
+
+        m_msg_count = 0;
+        m_iov_count = 0;
+        m_last_destination = -1;
+    }
+
+    int receive(uint8_t* buffer, int slot_size, int max_datagrams, int* sizes, int64_t* arrival_unix_ns) override {
+        int count = qMin(max_datagrams, max_receive_batch);
+        for (int i = 0; i < count; ++i) {
+            m_receive_iov[i].iov_base = buffer + size_t(i) * size_t(slot_size);
+            m_receive_iov[i].iov_len = size_t(slot_size);
+            msghdr& hdr = m_receive_msgs[i].msg_hdr;
+            hdr.msg_name = nullptr;
+            hdr.msg_namelen = 0;
+            hdr.msg_iov = &m_receive_iov[i];
+            hdr.msg_iovlen = 1;
+            hdr.msg_control = m_receive_cmsg[i].buffer;
+            hdr.msg_controllen = sizeof(m_receive_cmsg[i].buffer);
+            hdr.msg_flags = 0;
+        }
+
+        int received = ::recvmmsg(m_fd, m_receive_msgs, unsigned(count), MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+            return 0;
+        }
+
+        int64_t fallback_ns = -1;
+        for (int i = 0; i < received; ++i) {
+            msghdr& hdr = m_receive_msgs[i].msg_hdr;
+            sizes[i] = (hdr.msg_flags & MSG_TRUNC) ? 0 : int(m_receive_msgs[i].msg_len);
+            arrival_unix_ns[i] = -1;
+            for (cmsghdr* cm = CMSG_FIRSTHDR(&hdr); cm; cm = CMSG_NXTHDR(&hdr, cm)) {
+                if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_TIMESTAMPNS) {
+                    timespec ts;
+                    memcpy(&ts, CMSG_DATA(cm), sizeof(ts));
+                    arrival_unix_ns[i] = int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+                }
+            }
+            if (arrival_unix_ns[i] < 0) {
+                if (fallback_ns < 0) {
+                    fallback_ns = RtpClock::unix_ns();
+                }
+                arrival_unix_ns[i] = fallback_ns;
+            }
+        }
+        return received;
+    }
+
+    const char* name() const override {
+        return m_gso ? "sendmmsg+GSO" : "sendmmsg";
+    }
+
+private:
+    struct Destination {
+        sockaddr_storage address;
+        socklen_t length;
+        int fd;
+    };
+
+    struct Message {
+        int segments;
+        int iov_per_segment;
+    };
+
+    union ControlBuffer {
+        char buffer[CMSG_SPACE(sizeof(uint16_t))];
+        cmsghdr align;
+    };
+
+    union ReceiveControlBuffer {
+        char buffer[CMSG_SPACE(sizeof(timespec))];
+        cmsghdr align;
+    };
+
+    void set_segment_size(int msg, int size) {
+        msghdr& hdr = m_msgs[msg].msg_hdr;
+        hdr.msg_control = m_cmsg[msg].buffer;
+        hdr.msg_controllen = sizeof(m_cmsg[msg].buffer);
+        cmsghdr* cm = CMSG_FIRSTHDR(&hdr);
+        cm->cmsg_level = SOL_UDP;
+        cm->cmsg_type = UDP_SEGMENT;
+        cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t segment = uint16_t(size);
+        memcpy(CMSG_DATA(cm), &segment, sizeof(segment));
+    }
+
+    void send_segments(int msg) {
+        const msghdr& gso_hdr = m_msgs[msg].msg_hdr;
+        const Message& info = m_info[msg];
+        for (int i = 0; i < info.segments; ++i) {
+            msghdr hdr{};
+            hdr.msg_name = gso_hdr.msg_name;
+            hdr.msg_namelen = gso_hdr.msg_namelen;
+            hdr.msg_iov = gso_hdr.msg_iov + i * info.iov_per_segment;
+            hdr.msg_iovlen = size_t(info.iov_per_segment);
+            m_stats.syscalls++;
+            if (::sendmsg(m_batch_fd, &hdr, 0) < 0) {
+                m_stats.dropped++;
+            }
+        }
+    }
+
+    int m_fd = -1;
+    int m_batch_fd = -1;
+    int m_family = AF_INET6;
+    bool m_gso = false;
+    std::vector<Destination> m_destinations;
+    std::vector<mmsghdr> m_msgs;
+    std::vector<Message> m_info;
+    std::vector<iovec> m_iov;
+    std::vector<ControlBuffer> m_cmsg;
+    int m_msg_count = 0;
+    int m_iov_count = 0;
+    int m_last_destination = -1;
+    int m_last_size = 0;
+    mmsghdr m_receive_msgs[max_receive_batch];
+    iovec m_receive_iov[max_receive_batch];
+    ReceiveControlBuffer m_receive_cmsg[max_receive_batch];
+};
+#endif
+
+std::unique_ptr<RtpTransport> RtpTransport::create() {
+#ifdef Q_OS_LINUX
+    std::unique_ptr<MmsgRtpTransport> transport(new MmsgRtpTransport());
+    if (transport->open()) {
+        return std::move(transport);
+    }
+    qWarning() << "Native UDP-socket not available, falling back to QUdpSocket";
+#endif
+    return std::unique_ptr<RtpTransport>(new QtRtpTransport());
+}
+
+QtRtpTransport::QtRtpTransport() : m_socket(new QUdpSocket()) {}
+
+QtRtpTransport::~QtRtpTransport() {
+    delete m_socket;
+}
+
+int QtRtpTransport::add_destination(const QHostAddress& address, quint16 port, qintptr socket) {
+    if (address.isNull()) {
+        return -1;
+    }
+    QByteArray socket_address;
+    if (socket >= 0) {
+        //QUdpSocket would take over the descriptor, so the foreign socket is written natively
+        socket_address = RtpSocketHandle::socket_address(socket, address, port);
+        if (socket_address.isEmpty()) {
+            return -1;
+        }
+    }
+    m_destinations.push_back({address, port, socket, socket_address});
+    return int(m_destinations.size()) - 1;
+}
+
+void QtRtpTransport::queue(const uint8_t* header, int header_size, const uint8_t* payload, int payload_size, int destination) {
+    if (destination < 0) {
+        m_stats.dropped++;
+        return;
+    }
+
+    //QUdpSocket needs one contiguous buffer, so header and payload are joined in the scratch-buffer
+    const char* data = reinterpret_cast<const char*>(header);
+    int size = header_size;
+    if (payload) {
+        size = header_size + payload_size;
+        if (m_scratch.size() < size) {
+            m_scratch.resize(size);
+        }
+        memcpy(m_scratch.data(), header, size_t(header_size));
+        memcpy(m_scratch.data() + header_size, payload, size_t(payload_size));
+        data = m_scratch.constData();
+    }
+
+    const Destination& dest = m_destinations[destination];
+    m_stats.datagrams++;
+    m_stats.syscalls++;
+    if (dest.socket >= 0) {
+        if (!RtpSocketHandle::send_to(dest.socket, dest.socket_address, data, size)) {
+            m_stats.dropped++;
+        }
+    } else if (m_socket->writeDatagram(data, size, dest.address, dest.port) < 0) {
+        m_stats.dropped++;
+    }
+}
+
+int QtRtpTransport::receive(uint8_t* buffer, int slot_size, int max_datagrams, int* sizes, int64_t* arrival_unix_ns) {
+    int count = 0;
+    while (count < max_datagrams && m_socket->hasPendingDatagrams()) {
+        qint64 size = m_socket->readDatagram(reinterpret_cast<char*>(buffer) + qint64(count) * slot_size, slot_size);
+        if (size < 0) {
+            break;
+        }
+        sizes[count] = int(size);
+        arrival_unix_ns[count] = RtpClock::unix_ns();
+        count++;
+    }
+    return count;
+}
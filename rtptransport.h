@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtptransport.h/cpp:
+ *The RtpTransport-Class is the send-backend of a RtpWorker. The worker
+ *queues every paket which is due in one scheduling tick and flushes them
+ *together at the end of the tick.
+ *On Linux the MmsgRtpTransport hands the complete tick to the kernel with
+ *one sendmmsg-call and coalesces consecutive pakets with the same size and
+ *destination into one UDP-GSO (UDP_SEGMENT) message where the kernel
+ *supports it. On all other platforms (or if the native socket can not be
+ *created) the QtRtpTransport sends every paket with QUdpSocket.
+ *A paket is queued as header plus optional payload, so payloads can be
+ *sent directly out of a shared RtpAudioAsset without copying them.
+ *Both count datagrams and syscalls, so the saved syscalls are visible.
+ *receive() reads what comes back to the socket (RTCP-reports) without
+ *blocking, on Linux with the receive-time of the kernel.
+ *A destination can be bound to a foreign socket (the media-socket of a
+ *SIP-call), consecutive pakets over the same socket are still batched.
+ *The QtRtpTransport sends over a foreign socket with plain sendto().
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPTRANSPORT_H
+#define RTPTRANSPORT_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QVector>
+
+#include <cstdint>
+#include <memory>
+
+class QUdpSocket;
+
+struct RtpTransportStats {
+    quint64 datagrams = 0;
+    quint64 syscalls = 0;
+    quint64 dropped = 0;
+};
+
+class RtpTransport {
+
+public:
+    virtual ~RtpTransport() = default;
+
+    //Returns a handle for queue() or -1 if the destination is not reachable by this backend.
+    //socket >= 0 sends to this destination over a foreign socket (see rtpsockethandle.h/cpp)
+    virtual int add_destination(const QHostAddress& address, quint16 port, qintptr socket = -1) = 0;
+    //payload may be nullptr if the complete paket is in header
+    virtual void queue(const uint8_t* header, int header_size, const uint8_t* payload, int payload_size, int destination) = 0;
+    virtual void flush() = 0;
+    //Non-blocking, reads at most max_datagrams into consecutive slots of slot_size bytes.
+    //Returns the number of datagrams, their sizes and wallclock arrival-times.
+    virtual int receive(uint8_t* buffer, int slot_size, int max_datagrams, int* sizes, int64_t* arrival_unix_ns) = 0;
+    virtual const char* name() const = 0;
+
+    const RtpTransportStats& stats() const { return m_stats; }
+
+    static std::unique_ptr<RtpTransport> create();
+
+protected:
+    RtpTransportStats m_stats;
+};
+
+class QtRtpTransport : public RtpTransport {
+
+public:
+    QtRtpTransport();
+    ~QtRtpTransport();
+
+    int add_destination(const QHostAddress& address, quint16 port, qintptr socket = -1) override;
+    void queue(const uint8_t* header, int header_size, const uint8_t* payload, int payload_size, int destination) override;
+    void flush() override {}
+    int receive(uint8_t* buffer, int slot_size, int max_datagrams, int* sizes, int64_t* arrival_unix_ns) override;
+    const char* name() const override { return "QUdpSocket"; }
+
+private:
+    struct Destination {
+        QHostAddress address;
+        quint16 port;
+        qintptr socket;               //-1 = m_socket
+        QByteArray socket_address;    //native address for the foreign socket
+    };
+
+    QUdpSocket* m_socket;
+    QVector<Destination> m_destinations;
+    QByteArray m_scratch;
+};
+
+#endif // RTPTRANSPORT_H
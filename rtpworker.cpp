@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpworker.h/cpp:
+ *The RtpWorker-Class is one sender-thread of the RtpEngine. Every worker
+ *owns a subset of the RtpStreams (see rtpstream.h/cpp) together with their
+ *complete state and one socket, so the hot path never shares mutable data
+ *with another thread.
+ *The streams of a worker are scheduled with a min-heap ordered by their
+ *next absolute deadline on the RtpClock. The worker sleeps until the
+ *earliest deadline and then sends every paket which is due. All pakets of
+ *one wakeup are handed to the RtpTransport (see rtptransport.h/cpp) as one
+ *batch.
+ *RTCP has no timer per stream: a timing-wheel with 100 ms buckets collects
+ *the streams whose report is due, all reports of a bucket go out as one
+ *batch over a second socket, which also receives the reports of the far end.
+ *DTMF is fired from another thread through a mailbox which the worker
+ *checks once per wakeup, the streams take the shared plan with their next slot.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+
+#include "rtpworker.h"
+#include "rtpclock.h"
+
+#include <QDebug>
+#include <QRandomGenerator>
+
+#include <algorithm>
+
+//Reports are sent to the ui once per second per worker
+const int64_t stats_interval_ns = 1000000000LL;
+//If a stream is behind for more than this many pakets the schedule is rebased
+//instead of bursting all missed pakets out at once
+const int max_catch_up_pakets = 5;
+//RTCP timing-wheel: 128 buckets of 100 ms, longer intervals take another round
+const int64_t rtcp_tick_ns = 100000000LL;
+const int rtcp_wheel_size = 128;
+//Compound-pakets rendered before the RTCP-socket is flushed
+const int rtcp_batch = 256;
+const int rtcp_receive_slot = 1500;
+const int rtcp_receive_batch = 64;
+const int max_report_blocks = 31;
+
+RtpWorker::RtpWorker(const std::atomic<bool>& running, StatsReporter reporter)
+    : m_running(running), m_reporter(std::move(reporter)) {}
+
+void RtpWorker::add_stream(const RtpStream& stream) {
+    m_streams.push_back(stream);
+}
+
+int RtpWorker::stream_count() const {
+    return int(m_streams.size());
+}
+
+void RtpWorker::run() {
+    RtpClock::raise_thread_priority();
+
+    //Created on the worker-thread, so the socket is owned by it
+    m_transport = RtpTransport::create();
+    m_reported_transport = RtpTransportStats();
+    for (RtpStream& stream : m_streams) {
+        const RtpStreamConfig& config = stream.config();
+        qintptr socket = config.socket ? config.socket->descriptor() : -1;
+        stream.set_destination(m_transport->add_destination(config.destination, config.port, socket));
+        if (stream.destination() < 0) {
+            qWarning() << "Destination not supported by" << m_transport->name() << ":" << config.destination.toString();
+        }
+    }
+
+    int max_paket_size = 0;
+    for (const RtpStream& stream : m_streams) {
+        max_paket_size = qMax(max_paket_size, stream.builder().paket_size());
+    }
+    m_pool.init(int(m_streams.size()), max_paket_size);
+    for (int i = 0; i < int(m_streams.size()); ++i) {
+        m_pool.init_stream(i, m_streams[i].builder());
+    }
+
+    //Spread the first deadlines over one ptime, so not all streams fire at the same instant
+    const int64_t start_ns = RtpClock::now_ns();
+    const int64_t count = int64_t(m_streams.size());
+    m_schedule.clear();
+    m_schedule.reserve(m_streams.size());
+    for (int i = 0; i < int(m_streams.size()); ++i) {
+        m_schedule.push_back({start_ns + (i * m_streams[i].ptime_ns()) / count, i});
+    }
+    std::make_heap(m_schedule.begin(), m_schedule.end(), RtpWorker::later_deadline);
+
+    int64_t next_report_ns = start_ns + stats_interval_ns;
+    RtpWorker::start_rtcp(start_ns);
+
+    while (m_running.load(std::memory_order_relaxed) && !m_schedule.empty()) {
+        RtpClock::sleep_until(m_schedule.front().deadline_ns);
+        int64_t now_ns = RtpClock::now_ns();
+
+        while (!m_schedule.empty() && m_schedule.front().deadline_ns <= now_ns) {
+            std::pop_heap(m_schedule.begin(), m_schedule.end(), RtpWorker::later_deadline);
+            ScheduleEntry entry = m_schedule.back();
+            m_schedule.pop_back();
+
+            RtpStream& stream = m_streams[entry.stream];
+            RtpWorker::send_paket(entry.stream, entry.deadline_ns, now_ns);
+            if (stream.finished()) {
+                continue;
+            }
+
+            //Next deadline is always derived from the previous deadline, never from "now"
+            entry.deadline_ns += stream.ptime_ns();
+            if (now_ns - entry.deadline_ns > max_catch_up_pakets * stream.ptime_ns()) {
+                entry.deadline_ns = now_ns + stream.ptime_ns();
+                stream.record_resync();
+            }
+            m_schedule.push_back(entry);
+            std::push_heap(m_schedule.begin(), m_schedule.end(), RtpWorker::later_deadline);
+        }
+        m_transport->flush();
+
+        if (m_dtmf_pending.load(std::memory_order_acquire)) {
+            RtpWorker::start_dtmf();
+        }
+
+        if (m_rtcp_transport && now_ns - m_rtcp_start_ns >= int64_t(m_rtcp_tick) * rtcp_tick_ns) {
+            RtpWorker::rtcp_tick(now_ns);
+        }
+
+        if (now_ns >= next_report_ns) {
+            RtpWorker::report_stats();
+            while (next_report_ns <= now_ns) {
+                next_report_ns += stats_interval_ns;
+            }
+        }
+    }
+
+    m_transport->flush();
+    RtpWorker::stop_rtcp();
+    RtpWorker::report_stats();
+    m_transport.reset();
+    m_rtcp_transport.reset();
+}
+
+//Min-heap: the entry with the earliest deadline is at the front
+bool RtpWorker::later_deadline(const ScheduleEntry& a, const ScheduleEntry& b) {
+    return a.deadline_ns > b.deadline_ns;
+}
+
+void RtpWorker::send_paket(int index, int64_t deadline_ns, int64_t now_ns) {
+    RtpStream& stream = m_streams[index];
+    stream.record_slot(deadline_ns);
+    const uint8_t* payload = nullptr;
+    int payload_size = 0;
+    uint8_t* paket = stream.next_paket(m_pool, index, payload, payload_size);
+    if (paket) {
+        if (payload) {
+            m_transport->queue(paket, RtpPacketBuilder::header_size, payload, payload_size, stream.destination());
+        } else {
+            m_transport->queue(paket, RtpPacketBuilder::header_size + payload_size, nullptr, 0, stream.destination());
+        }
+        stream.record_send(deadline_ns, now_ns, payload_size);
+    }
+}
+
+void RtpWorker::fire_dtmf(const std::shared_ptr<const RtpDtmfPlan>& plan) {
+    std::lock_guard<std::mutex> lock(m_dtmf_mutex);
+    m_pending_dtmf = plan;
+    m_dtmf_pending.store(true, std::memory_order_release);
+}
+
+void RtpWorker::start_dtmf() {
+    std::shared_ptr<const RtpDtmfPlan> plan;
+    {
+        std::lock_guard<std::mutex> lock(m_dtmf_mutex);
+        plan.swap(m_pending_dtmf);
+        m_dtmf_pending.store(false, std::memory_order_relaxed);
+    }
+    //Streams still sending the previous sequence skip this one, an event is never cut
+    for (RtpStream& stream : m_streams) {
+        stream.start_dtmf(plan);
+    }
+}
+
+void RtpWorker::report_stats() {
+    if (!m_reporter) {
+        return;
+    }
+
+    QVector<RtpStreamStats> stats;
+    stats.reserve(int(m_streams.size()));
+    for (const RtpStream& stream : m_streams) {
+        stats.push_back(stream.stats());
+    }
+
+    const RtpTransportStats& total = m_transport->stats();
+    RtpTransportStats delta;
+    delta.datagrams = total.datagrams - m_reported_transport.datagrams;
+    delta.syscalls = total.syscalls - m_reported_transport.syscalls;
+    delta.dropped = total.dropped - m_reported_transport.dropped;
+    m_reported_transport = total;
+
+    m_reporter(stats, delta);
+}
+
+void RtpWorker::start_rtcp(int64_t start_ns) {
+    m_rtcp_start_ns = start_ns;
+    m_rtcp_tick = 0;
+    m_rtcp_wheel.assign(rtcp_wheel_size, std::vector<int>());
+    m_rtcp_deadlines.assign(m_streams.size(), -1);
+    m_rtcp_ssrcs.clear();
+    m_rtcp_buffer.resize(size_t(rtcp_batch) * RtcpPacket::max_compound_size);
+    m_rtcp_receive_buffer.resize(size_t(rtcp_receive_slot) * rtcp_receive_batch);
+    m_rtcp_queued = 0;
+
+    bool any = false;
+    for (const RtpStream& stream : m_streams) {
+        any = any || stream.config().rtcp_interval_ms > 0;
+    }
+    if (!any) {
+        return;
+    }
+
+    //Own socket, so RTCP leaves from another port than RTP and the reports come back to it
+    m_rtcp_transport = RtpTransport::create();
+    for (int i = 0; i < int(m_streams.size()); ++i) {
+        RtpStream& stream = m_streams[i];
+        const RtpStreamConfig& config = stream.config();
+        if (config.rtcp_interval_ms <= 0) {
+            continue;
+        }
+        quint16 port = config.rtcp_port != 0 ? config.rtcp_port : quint16(config.port + 1);
+        stream.set_rtcp_destination(m_rtcp_transport->add_destination(config.destination, port));
+        if (stream.rtcp_destination() < 0) {
+            continue;
+        }
+        m_rtcp_ssrcs.insert(stream.ssrc(), 0, i);
+
+        //RFC 3550 6.2: the first report after half an interval
+        int64_t interval_ns = int64_t(config.rtcp_interval_ms) * 1000000LL;
+        RtpWorker::schedule_rtcp(i, start_ns + int64_t(interval_ns * (0.25 + QRandomGenerator::global()->generateDouble() * 0.5)));
+    }
+}
+
+void RtpWorker::schedule_rtcp(int index, int64_t deadline_ns) {
+    m_rtcp_deadlines[index] = deadline_ns;
+    uint64_t tick = uint64_t(qMax<int64_t>(0, deadline_ns - m_rtcp_start_ns) / rtcp_tick_ns);
+    //Never into the bucket just being processed, beyond the wheel it is re-checked one round later
+    tick = qBound(m_rtcp_tick + 1, tick, m_rtcp_tick + rtcp_wheel_size - 1);
+    m_rtcp_wheel[tick % rtcp_wheel_size].push_back(index);
+}
+
+void RtpWorker::rtcp_tick(int64_t now_ns) {
+    int64_t unix_ns = RtpClock::unix_ns();
+    uint64_t current = uint64_t(now_ns - m_rtcp_start_ns) / rtcp_tick_ns;
+    std::vector<int> due;
+    //Late wakeups process every missed bucket, but at most one round
+    for (uint64_t tick = qMax(m_rtcp_tick, current >= rtcp_wheel_size ? current - rtcp_wheel_size + 1 : 0); tick <= current; ++tick) {
+        m_rtcp_tick = tick;
+        due.clear();
+        due.swap(m_rtcp_wheel[tick % rtcp_wheel_size]);
+        for (int index : due) {
+            if (m_rtcp_deadlines[index] < 0) {
+                continue;
+            }
+            if (m_rtcp_deadlines[index] > now_ns + rtcp_tick_ns) {
+                RtpWorker::schedule_rtcp(index, m_rtcp_deadlines[index]);
+                continue;
+            }
+
+            RtpStream& stream = m_streams[index];
+            bool bye = stream.finished();
+            RtpWorker::send_rtcp(index, now_ns, unix_ns, bye);
+            if (bye) {
+                m_rtcp_deadlines[index] = -1;
+                continue;
+            }
+            int64_t interval_ns = int64_t(stream.config().rtcp_interval_ms) * 1000000LL;
+            RtpWorker::schedule_rtcp(index, now_ns + int64_t(interval_ns * (0.5 + QRandomGenerator::global()->generateDouble())));
+        }
+    }
+    m_rtcp_tick = current + 1;
+
+    m_rtcp_transport->flush();
+    m_rtcp_queued = 0;
+    RtpWorker::receive_rtcp();
+}
+
+void RtpWorker::send_rtcp(int index, int64_t now_ns, int64_t unix_ns, bool bye) {
+    if (m_rtcp_queued == rtcp_batch) {
+        m_rtcp_transport->flush();
+        m_rtcp_queued = 0;
+    }
+
+    RtpStream& stream = m_streams[index];
+    //After a SSRC-change the reports of the far end arrive for the new SSRC
+    if (m_rtcp_ssrcs.find(stream.ssrc(), 0) != index) {
+        m_rtcp_ssrcs.insert(stream.ssrc(), 0, index);
+    }
+
+    uint8_t* paket = m_rtcp_buffer.data() + size_t(m_rtcp_queued++) * RtcpPacket::max_compound_size;
+    int size = stream.write_rtcp(paket, now_ns, unix_ns, bye);
+    m_rtcp_transport->queue(paket, size, nullptr, 0, stream.rtcp_destination());
+}
+
+void RtpWorker::receive_rtcp() {
+    int sizes[rtcp_receive_batch];
+    int64_t arrivals[rtcp_receive_batch];
+    RtcpReportBlock blocks[max_report_blocks];
+
+    int received = 0;
+    do {
+        received = m_rtcp_transport->receive(m_rtcp_receive_buffer.data(), rtcp_receive_slot, rtcp_receive_batch, sizes, arrivals);
+        for (int i = 0; i < received; ++i) {
+            const uint8_t* data = m_rtcp_receive_buffer.data() + size_t(i) * rtcp_receive_slot;
+            int count = RtcpPacket::parse_report_blocks(data, sizes[i], blocks, max_report_blocks);
+            uint32_t arrival = RtcpPacket::ntp_middle(RtcpPacket::ntp_timestamp(arrivals[i]));
+            for (int b = 0; b < count; ++b) {
+                int index = m_rtcp_ssrcs.find(blocks[b].ssrc, 0);
+                if (index < 0 || m_streams[index].ssrc() != blocks[b].ssrc) {
+                    continue;
+                }
+                m_streams[index].record_report(blocks[b], RtcpPacket::round_trip_ms(arrival, blocks[b]));
+            }
+        }
+    } while (received == rtcp_receive_batch);
+}
+
+void RtpWorker::stop_rtcp() {
+    if (!m_rtcp_transport) {
+        return;
+    }
+
+    //RFC 3550 6.6: every stream still reporting says goodbye
+    int64_t now_ns = RtpClock::now_ns();
+    int64_t unix_ns = RtpClock::unix_ns();
+    for (int i = 0; i < int(m_streams.size()); ++i) {
+        if (m_rtcp_deadlines[i] >= 0) {
+            RtpWorker::send_rtcp(i, now_ns, unix_ns, true);
+            m_rtcp_deadlines[i] = -1;
+        }
+    }
+    m_rtcp_transport->flush();
+    m_rtcp_queued = 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file rtpworker.h/cpp:
+ *The RtpWorker-Class is one sender-thread of the RtpEngine. Every worker
+ *owns a subset of the RtpStreams (see rtpstream.h/cpp) together with their
+ *complete state and one socket, so the hot path never shares mutable data
+ *with another thread.
+ *The streams of a worker are scheduled with a min-heap ordered by their
+ *next absolute deadline on the RtpClock. The worker sleeps until the
+ *earliest deadline and then sends every paket which is due. All pakets of
+ *one wakeup are handed to the RtpTransport (see rtptransport.h/cpp) as one
+ *batch.
+ *RTCP has no timer per stream: a timing-wheel with 100 ms buckets collects
+ *the streams whose report is due, all reports of a bucket go out as one
+ *batch over a second socket, which also receives the reports of the far end.
+ *DTMF is fired from another thread through a mailbox which the worker
+ *checks once per wakeup, the streams take the shared plan with their next slot.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef RTPWORKER_H
+#define RTPWORKER_H
+
+#include "rtpengine.h"
+#include "rtppacketbuilder.h"
+#include "rtpssrctable.h"
+#include "rtpstream.h"
+#include "rtptransport.h"
+
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class RtpWorker {
+
+public:
+    using StatsReporter = std::function<void(const QVector<RtpStreamStats>& stats, const RtpTransportStats& transport_delta)>;
+
+    RtpWorker(const std::atomic<bool>& running, StatsReporter reporter);
+
+    void add_stream(const RtpStream& stream);
+    int stream_count() const;
+    void run();
+    //Thread-safe, a plan fired before the previous one was taken replaces it
+    void fire_dtmf(const std::shared_ptr<const RtpDtmfPlan>& plan);
+
+private:
+    struct ScheduleEntry {
+        int64_t deadline_ns;
+        int stream;
+    };
+
+    static bool later_deadline(const ScheduleEntry& a, const ScheduleEntry& b);
+    void send_paket(int index, int64_t deadline_ns, int64_t now_ns);
+    void report_stats();
+    void start_dtmf();
+
+    void start_rtcp(int64_t start_ns);
+    void schedule_rtcp(int index, int64_t deadline_ns);
+    void rtcp_tick(int64_t now_ns);
+    void send_rtcp(int index, int64_t now_ns, int64_t unix_ns, bool bye);
+    void receive_rtcp();
+    void stop_rtcp();
+
+    const std::atomic<bool>& m_running;
+    StatsReporter m_reporter;
+    std::unique_ptr<RtpTransport> m_transport;
+    RtpTransportStats m_reported_transport;
+    std::vector<RtpStream> m_streams;
+    RtpPacketPool m_pool;
+    std::vector<ScheduleEntry> m_schedule;
+
+    std::unique_ptr<RtpTransport> m_rtcp_transport;
+    std::vector<std::vector<int>> m_rtcp_wheel;
+    std::vector<int64_t> m_rtcp_deadlines;     //-1 = no RTCP (anymore) for this stream
+    uint64_t m_rtcp_tick = 0;
+    int64_t m_rtcp_start_ns = 0;
+    RtpSsrcTable m_rtcp_ssrcs;
+    std::vector<uint8_t> m_rtcp_buffer;
+    std::vector<uint8_t> m_rtcp_receive_buffer;
+    int m_rtcp_queued = 0;
+
+    std::mutex m_dtmf_mutex;
+    std::shared_ptr<const RtpDtmfPlan> m_pending_dtmf;
+    std::atomic<bool> m_dtmf_pending{false};
+};
+
+#endif // RTPWORKER_H
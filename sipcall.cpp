@@ -24,11 +24,17 @@
  *responsible for the custom call-setup maintained and configured over
  *the ui in mainwindow.
  *This class is triggered and maintained by SipMachine-Class.
- *Currently it maintaines if 100rel/timer is acitvated or not. If this
- *will remain here depened on how I get this config-options get work with
- *PJSIP (because the default behaivor is to set both options in supported-
- *header and only get a easy way to elevate them in require-header. But
- *there is no option to fully delete both of them out of the INVITE-message)
+ *Which of 100rel/timer stay in the Supported-header is not decided per call
+ *but by the TX-program of the SipMachine (see SipTxPlan::supported_rules),
+ *because PJSIP always sets both options and only offers to elevate them to
+ *the Require-header.
+ *The media of a call is chosen per call (SipMediaConfig): the sound-device,
+ *silence or a shared file/tone-port which only transmits into the call, so
+ *load-calls never touch the sound-device or mix in the bridge.
+ *With custom RTP the stream of PJSIP is created paused for sending and the
+ *negotiated media (SipCallMedia) is handed to the RtpEngine instead,
+ *together with a duplicate of PJSIP's RTP-socket. A stream whose socket
+ *can not be duplicated is not paused and not handed over.
  *
  *
  * License:
@@ -50,23 +56,201 @@
 #include "sipcall.h"
 
 #include <QDebug>
+#include <QMetaObject>
 #include <QString>
 
-SipCall::SipCall(pj::Account& acc, int call_id) : pj::Call(acc, call_id) {}
+SipCall::SipCall(pj::Account& acc, int call_id)
+    : pj::Call(acc, call_id) {}
 
 void SipCall::onCallState(pj::OnCallStateParam& prm) {
     pj::CallInfo ci = getInfo();
-    qDebug() << "Call state changed: " << QString::fromStdString(ci.stateText);
+    if (m_media_observer && ci.state == PJSIP_INV_STATE_DISCONNECTED) {
+        QMetaObject::invokeMethod(m_media_observer, "on_call_media_ended", Qt::QueuedConnection, Q_ARG(int, ci.id));
+    }
+    if (!m_link) {
+        qDebug() << "Call state changed: " << QString::fromStdString(ci.stateText);
+    } else {
+        //Called from a PJSIP-thread: either handed to the handler-thread of this call-id or queued to the observer's thread
+        std::shared_ptr<SipCallLink> link = m_link;
+        int call_id = ci.id;
+        quint32 serial = m_serial;
+        int state = int(ci.state);
+        int status_code = int(ci.lastStatusCode);
+        if (m_dispatcher) {
+            m_dispatcher->post(call_id, [link, call_id, serial, state, status_code]() {
+                std::lock_guard<std::mutex> lock(link->mutex);
+                if (link->observer) {
+                    QMetaObject::invokeMethod(
+                        link->observer,
+                        "on_call_state",
+                        Qt::DirectConnection,
+                        Q_ARG(int, call_id),
+                        Q_ARG(quint32, serial),
+                        Q_ARG(int, state),
+                        Q_ARG(int, status_code));
+                }
+            });
+        } else {
+            std::lock_guard<std::mutex> lock(link->mutex);
+            if (link->observer) {
+                QMetaObject::invokeMethod(
+                    link->observer,
+                    "on_call_state",
+                    Qt::QueuedConnection,
+                    Q_ARG(int, call_id),
+                    Q_ARG(quint32, serial),
+                    Q_ARG(int, state),
+                    Q_ARG(int, status_code));
+            }
+        }
+    }
+
+    //Nothing of this object may be touched afterwards
+    if (m_delete_on_disconnect && ci.state == PJSIP_INV_STATE_DISCONNECTED) {
+        SipCall::release_reference();
+    }
+}
+
+void SipCall::release_creator() {
+    SipCall::release_reference();
+}
+
+void SipCall::release_reference() {
+    //The last of PJSIP (DISCONNECTED) and the creator (makeCall() returned) deletes the call
+    if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
 }
 
 void SipCall::onCallMediaState(pj::OnCallMediaStateParam& prm) {
+    if (m_media_observer) {
+        SipCall::publish_media();
+    }
+
+    //Null: the call-port stays unconnected, the bridge sends silence and never decodes its stream
+    if (m_media_mode == SipMediaConfig::Null || (m_media_mode != SipMediaConfig::SoundDevice && !m_media_source)) {
+        return;
+    }
+
     pj::CallInfo ci = getInfo();
     for (auto& media : ci.media) {
         if (media.type == PJMEDIA_TYPE_AUDIO && getMedia(media.index)) {
             pj::AudioMedia* audio_media = (pj::AudioMedia*) getMedia(media.index);
+            if (m_media_mode != SipMediaConfig::SoundDevice) {
+                //Only transmit, nothing is played back: the source is read once per frame for all calls
+                m_media_source->startTransmit(*audio_media);
+                continue;
+            }
             pj::AudDevManager& mgr = pj::Endpoint::instance().audDevManager();
             mgr.getCaptureDevMedia().startTransmit(*audio_media);
             audio_media->startTransmit(mgr.getPlaybackDevMedia());
         }
     }
 }
+
+void SipCall::onStreamCreated(pj::OnStreamCreatedParam& prm) {
+    if (!m_custom_rtp) {
+        return;
+    }
+    //Only paused if the RtpEngine can send over the same socket, otherwise PJSIP keeps sending and
+    //the remote side (latching on the SDP-port) would get two streams from two ports
+    pjmedia_transport_info transport_info;
+    pjmedia_transport_info_init(&transport_info);
+    std::shared_ptr<const RtpSocketHandle> socket;
+    if (pjsua_call_get_med_transport_info(getId(), prm.streamIdx, &transport_info) == PJ_SUCCESS) {
+        socket = RtpSocketHandle::duplicate(qintptr(transport_info.sock_info.rtp_sock));
+    }
+    if (!socket) {
+        qWarning() << "RTP-socket of call" << getId() << "not shared, PJSIP keeps sending";
+        m_rtp_sockets.remove(prm.streamIdx);
+        return;
+    }
+    //PJSIP keeps receiving (and sending RTCP), the RTP is sent by the RtpEngine
+    m_rtp_sockets.insert(prm.streamIdx, socket);
+    pjmedia_stream_pause(static_cast<pjmedia_stream*>(prm.stream), PJMEDIA_DIR_ENCODING);
+}
+
+void SipCall::onStreamDestroyed(pj::OnStreamDestroyedParam& prm) {
+    //A running RtpStream keeps its own reference until the engine is stopped
+    m_rtp_sockets.remove(prm.streamIdx);
+}
+
+void SipCall::publish_media() {
+    pjsua_call_id call_id = getId();
+    pjsua_call_info info;
+    if (pjsua_call_get_info(call_id, &info) != PJ_SUCCESS) {
+        return;
+    }
+
+    //Only the first active audio-stream, the generator sends one stream per call
+    for (unsigned i = 0; i < info.media_cnt; ++i) {
+        if (info.media[i].type != PJMEDIA_TYPE_AUDIO || info.media[i].status != PJSUA_CALL_MEDIA_ACTIVE) {
+            continue;
+        }
+        pjsua_stream_info stream_info;
+        if (pjsua_call_get_stream_info(call_id, i, &stream_info) != PJ_SUCCESS || stream_info.type != PJMEDIA_TYPE_AUDIO) {
+            continue;
+        }
+        const pjmedia_stream_info& audio = stream_info.info.aud;
+
+        SipCallMedia media;
+        media.call_id = call_id;
+        char address[PJ_INET6_ADDRSTRLEN];
+        pj_sockaddr_print(&audio.rem_addr, address, sizeof(address), 0);
+        media.remote_address = QHostAddress(QString::fromLatin1(address));
+        media.remote_port = quint16(pj_sockaddr_get_port(&audio.rem_addr));
+        media.codec = QString::fromLatin1(audio.fmt.encoding_name.ptr, int(audio.fmt.encoding_name.slen));
+        media.payload_type = int(audio.tx_pt);
+        if (audio.param) {
+            media.ptime_ms = int(audio.param->info.frm_ptime) * qMax(1, int(audio.param->setting.frm_per_pkt));
+        }
+        media.event_payload_type = audio.tx_event_pt;
+        media.ssrc = audio.ssrc;
+
+        //Duplicated in onStreamCreated, only set if PJSIP's stream is paused
+        media.socket = m_rtp_sockets.value(i);
+
+        QMetaObject::invokeMethod(m_media_observer, "on_call_media", Qt::QueuedConnection, Q_ARG(SipCallMedia, media));
+        return;
+    }
+}
+
+bool SipCallMedia::stream_config(RtpStreamConfig& config) const {
+    if (!socket) {
+        qWarning() << "PJSIP sends the call itself, its RTP-socket is not shared";
+        return false;
+    }
+    QString name = codec.toUpper();
+    if (name != "PCMA" && name != "PCMU" && name != "G722") {
+        qWarning() << "Negotiated codec not supported by the RTP-generator:" << codec;
+        return false;
+    }
+    config.payload_type = name;
+    config.destination = remote_address;
+    config.port = remote_port;
+    config.ptime_ms = ptime_ms;
+    config.event_payload_type = event_payload_type;
+    config.socket = socket;
+    //PJSIP's paused stream still runs the RTCP of this port, so the RTP has to carry its SSRC.
+    //A start-SSRC of the scenario still overrides it on purpose.
+    config.rtcp_interval_ms = 0;
+    config.ssrc = QString("0x%1").arg(ssrc, 8, 16, QChar('0'));
+    return true;
+}
+
+bool SipMediaConfig::parse_mode(const QString& name, Mode& mode) {
+    QString lower = name.toLower();
+    if (lower == "sound") {
+        mode = SoundDevice;
+    } else if (lower == "null") {
+        mode = Null;
+    } else if (lower == "file") {
+        mode = File;
+    } else if (lower == "tone") {
+        mode = Tone;
+    } else {
+        qWarning() << "Unknown media mode:" << name;
+        return false;
+    }
+    return true;
+}
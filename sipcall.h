@@ -24,11 +24,17 @@
  *responsible for the custom call-setup maintained and configured over
  *the ui in mainwindow.
  *This class is triggered and maintained by SipMachine-Class.
- *Currently it maintaines if 100rel/timer is acitvated or not. If this
- *will remain here depened on how I get this config-options get work with
- *PJSIP (because the default behaivor is to set both options in supported-
- *header and only get a easy way to elevate them in require-header. But
- *there is no option to fully delete both of them out of the INVITE-message)
+ *Which of 100rel/timer stay in the Supported-header is not decided per call
+ *but by the TX-program of the SipMachine (see SipTxPlan::supported_rules),
+ *because PJSIP always sets both options and only offers to elevate them to
+ *the Require-header.
+ *The media of a call is chosen per call (SipMediaConfig): the sound-device,
+ *silence or a shared file/tone-port which only transmits into the call, so
+ *load-calls never touch the sound-device or mix in the bridge.
+ *With custom RTP the stream of PJSIP is created paused for sending and the
+ *negotiated media (SipCallMedia) is handed to the RtpEngine instead,
+ *together with a duplicate of PJSIP's RTP-socket. A stream whose socket
+ *can not be duplicated is not paused and not handed over.
  *
  *
  * License:
@@ -52,6 +58,51 @@
 
 #include <pjsua2.hpp>
 
+#include <QObject>
+#include <QHash>
+#include <QHostAddress>
+#include <QMetaType>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "sipdispatcher.h"
+#include "rtpengine.h"
+#include "rtpsockethandle.h"
+
+struct SipMediaConfig {
+    enum Mode { SoundDevice, Null, File, Tone };
+
+    Mode mode = SoundDevice;
+    QString file;           //File: WAV-file played in a loop into every call
+    int tone_hz = 1000;     //Tone: continuous sine into every call
+
+    static bool parse_mode(const QString& name, Mode& mode);
+};
+
+struct SipCallMedia {
+    int call_id = -1;
+    QHostAddress remote_address;
+    quint16 remote_port = 0;
+    QString codec;                  //encoding-name of the SDP, e.g. PCMA
+    int payload_type = -1;
+    int ptime_ms = 20;
+    int event_payload_type = -1;    //telephone-event, -1 = not negotiated
+    quint32 ssrc = 0;               //SSRC of PJSIP's stream, its RTCP keeps reporting it
+    std::shared_ptr<const RtpSocketHandle> socket;     //PJSIP's RTP-socket, nullptr = not shared
+
+    //false if the generator does not support the negotiated codec or PJSIP sends the call itself
+    bool stream_config(RtpStreamConfig& config) const;
+};
+Q_DECLARE_METATYPE(SipCallMedia)
+
+//Observer of the call-load, detached under the mutex when it stops - the calls may outlive it
+struct SipCallLink {
+    std::mutex mutex;
+    QObject* observer = nullptr;
+};
 
 class SipCall : public pj::Call {
 
@@ -59,9 +110,38 @@ public:
     SipCall(pj::Account& acc, int call_id = PJSUA_INVALID_ID);
     void onCallState(pj::OnCallStateParam& prm) override;
     void onCallMediaState(pj::OnCallMediaStateParam& prm) override;
+    void onStreamCreated(pj::OnStreamCreatedParam& prm) override;
+    void onStreamDestroyed(pj::OnStreamDestroyedParam& prm) override;
+
+    //Call-load: the state changes are forwarded to the observer of the link, the serial identifies
+    //this call after PJSIP reused the call-id.
+    std::shared_ptr<SipCallLink> m_link;
+    SipDispatcher* m_dispatcher = nullptr;     //null = the observer gets the state in its own thread
+    quint32 m_serial = 0;
+
+    //The call deletes itself in onCallState(DISCONNECTED) on the PJSIP-thread, so pjsua2 never
+    //destroys it after its id was reused. The creating thread holds a second reference until
+    //makeCall() returned and gives it up with release_creator(), only a call which already ended
+    //inside makeCall() is deleted there. If makeCall() throws there is no DISCONNECTED, the
+    //creator deletes the call directly.
+    bool m_delete_on_disconnect = false;
+    void release_creator();
+
+    //File/Tone: m_media_source is the shared port of the SipMachine, without it the call stays silent
+    SipMediaConfig::Mode m_media_mode = SipMediaConfig::SoundDevice;
+    pj::AudioMedia* m_media_source = nullptr;
+
+    //The media-observer gets on_call_media/on_call_media_ended, with custom RTP PJSIP does not send
+    //on every stream whose socket could be shared (RtpSocketHandle::supported() is checked before)
+    QObject* m_media_observer = nullptr;
+    bool m_custom_rtp = false;
+
+private:
+    void publish_media();
+    void release_reference();
 
-    bool m_rel_not_supported = false;
-    bool m_timer_not_supported = false;
+    std::atomic<int> m_references{2};
+    QHash<unsigned, std::shared_ptr<const RtpSocketHandle>> m_rtp_sockets;   //per paused stream-index, PJSIP-thread only
 };
 
 #endif // SIPCALL_H
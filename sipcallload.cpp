@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipcallload.h/cpp:
+ *The SipCallLoad-Class places calls over the load-accounts of the
+ *SipMachine with a configured rate (calls per second) and a limit of
+ *parallel calls. Every call lives in a slot indexed by its PJSIP call-id,
+ *the state changes of the calls are measured and reported as metrics:
+ *setup-latency (INVITE to 18x/200), success-ratio and reached rate.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipcallload.h"
+
+#include <QDebug>
+
+SipCallLoad::SipCallLoad(SipMachine* sip_machine, QObject* parent)
+    : QObject(parent), m_machine(sip_machine) {
+
+    m_tick_timer.setTimerType(Qt::PreciseTimer);
+    m_tick_timer.setInterval(5);
+    connect(&m_tick_timer, &QTimer::timeout, this, &SipCallLoad::tick);
+    m_report_timer.setInterval(1000);
+    connect(&m_report_timer, &QTimer::timeout, this, &SipCallLoad::report);
+}
+
+SipCallLoad::~SipCallLoad() {
+    SipCallLoad::stop();
+    SipCallLoad::detach();
+}
+
+bool SipCallLoad::start(const CallLoadConfig& config) {
+    if (m_machine->load_account_count() == 0) {
+        qWarning() << "Call-load without load-accounts";
+        return false;
+    }
+    if (config.destination.isEmpty() || config.cps <= 0.0 || config.max_concurrent <= 0) {
+        qWarning() << "Invalid call-load config";
+        return false;
+    }
+    //PJSUA_MAX_CALLS is fixed when PJSIP is built (32 in a stock build), more needs a PJSIP
+    //built with a larger PJSUA_MAX_CALLS in its config_site.h
+    if (config.max_concurrent > PJSUA_MAX_CALLS) {
+        qWarning() << "Call-load needs" << config.max_concurrent << "parallel calls, PJSIP is built with PJSUA_MAX_CALLS ="
+                   << PJSUA_MAX_CALLS << "- rebuild PJSIP with a larger PJSUA_MAX_CALLS";
+        return false;
+    }
+
+    //Calls of a previous run still disconnecting report to the old, detached link
+    SipCallLoad::detach();
+    m_link = std::make_shared<SipCallLink>();
+    m_link->observer = this;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_slots.clear();
+    m_slots.reserve(size_t(m_config.max_concurrent));
+    m_active = 0;
+
+    m_metrics = CallLoadMetrics();
+    m_ringing_sum_ms = 0.0;
+    m_answer_sum_ms = 0.0;
+    m_reported_attempts = 0;
+    m_next_account = 0;
+
+    m_clock.start();
+    m_interval_ns = qint64(1e9 / m_config.cps);
+    m_next_call_ns = 0;
+    m_report_ns = 0;
+    m_tick_timer.start();
+    m_report_timer.start();
+    return true;
+}
+
+void SipCallLoad::stop() {
+    if (!m_tick_timer.isActive()) {
+        return;
+    }
+    m_tick_timer.stop();
+    m_report_timer.stop();
+
+    std::vector<std::pair<int, SipCall*>> calls;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& entry : m_slots) {
+            Slot& slot = entry.second;
+            if (!slot.answered) {
+                m_metrics.failed++;
+            }
+            calls.push_back({slot.call_id, slot.call});
+        }
+        m_slots.clear();
+        m_active = 0;
+    }
+
+    //The calls delete themselves with their DISCONNECTED, their state is not followed anymore
+    SipCallLoad::detach();
+    for (const std::pair<int, SipCall*>& call : calls) {
+        SipCallLoad::hangup_call(call.first, call.second);
+    }
+    SipCallLoad::report();
+}
+
+bool SipCallLoad::is_running() const {
+    return m_tick_timer.isActive();
+}
+
+CallLoadMetrics SipCallLoad::metrics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_metrics;
+}
+
+void SipCallLoad::on_call_state(int call_id, quint32 serial, int state, int status_code) {
+    //With handler-threads this runs outside of the GUI-thread
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_slots.find(serial);
+    if (it == m_slots.end()) {
+        return;
+    }
+    Slot& slot = it->second;
+    slot.call_id = call_id;
+
+    qint64 now = m_clock.nsecsElapsed();
+    double setup_ms = double(now - slot.invite_ns) / 1e6;
+
+    if (state == PJSIP_INV_STATE_EARLY && status_code >= 180 && !slot.ringing) {
+        slot.ringing = true;
+        m_metrics.ringing++;
+        m_ringing_sum_ms += setup_ms;
+        m_metrics.ringing_max_ms = qMax(m_metrics.ringing_max_ms, setup_ms);
+    } else if ((state == PJSIP_INV_STATE_CONNECTING || state == PJSIP_INV_STATE_CONFIRMED) && !slot.answered) {
+        slot.answered = true;
+        slot.hangup_ns = now + qint64(m_config.hold_ms) * 1000000;
+        m_metrics.answered++;
+        m_answer_sum_ms += setup_ms;
+        m_metrics.answer_max_ms = qMax(m_metrics.answer_max_ms, setup_ms);
+    } else if (state == PJSIP_INV_STATE_DISCONNECTED) {
+        if (!slot.answered) {
+            qDebug() << "Load-call" << call_id << "failed:" << status_code;
+        }
+        SipCallLoad::release(serial);
+    }
+}
+
+void SipCallLoad::tick() {
+    std::vector<std::pair<int, SipCall*>> hangups;
+    std::vector<SipCall*> calls;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    qint64 now = m_clock.nsecsElapsed();
+
+    for (auto& entry : m_slots) {
+        Slot& slot = entry.second;
+        if (slot.hangup_ns != 0 && now >= slot.hangup_ns) {
+            //The slot is released with the DISCONNECTED-state
+            slot.hangup_ns = 0;
+            hangups.push_back({slot.call_id, slot.call});
+        }
+    }
+
+    bool all_placed = m_config.total_calls != 0 && m_metrics.attempted >= m_config.total_calls;
+    if (all_placed && m_active == 0) {
+        lock.unlock();
+        SipCallLoad::stop();
+        emit finished();
+        return;
+    }
+
+    //Calls are placed on an absolute schedule, a blocked slot (limit or no account) does not build up a burst
+    while (!all_placed && now >= m_next_call_ns) {
+        SipCall* call = m_active < m_config.max_concurrent ? SipCallLoad::prepare_call(now) : nullptr;
+        if (!call) {
+            m_next_call_ns = now + m_interval_ns;
+            break;
+        }
+        calls.push_back(call);
+        m_next_call_ns += m_interval_ns;
+        all_placed = m_config.total_calls != 0 && m_metrics.attempted >= m_config.total_calls;
+    }
+    lock.unlock();
+
+    //BYE and INVITE are sent without the slot-mutex, the handler-threads keep delivering states meanwhile
+    for (const std::pair<int, SipCall*>& hangup : hangups) {
+        SipCallLoad::hangup_call(hangup.first, hangup.second);
+    }
+    for (SipCall* call : calls) {
+        SipCallLoad::place_call(call);
+    }
+}
+
+void SipCallLoad::report() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    qint64 now = m_clock.nsecsElapsed();
+    double elapsed_s = double(now - m_report_ns) / 1e9;
+
+    m_metrics.active = m_active;
+    m_metrics.ringing_mean_ms = m_metrics.ringing ? m_ringing_sum_ms / double(m_metrics.ringing) : 0.0;
+    m_metrics.answer_mean_ms = m_metrics.answered ? m_answer_sum_ms / double(m_metrics.answered) : 0.0;
+    quint64 finished = m_metrics.answered + m_metrics.failed;
+    m_metrics.success_ratio = finished ? double(m_metrics.answered) / double(finished) : 0.0;
+    m_metrics.cps = elapsed_s > 0.0 ? double(m_metrics.attempted - m_reported_attempts) / elapsed_s : 0.0;
+
+    m_reported_attempts = m_metrics.attempted;
+    m_report_ns = now;
+    CallLoadMetrics metrics = m_metrics;
+    lock.unlock();
+    emit metrics_updated(metrics);
+}
+
+SipCall* SipCallLoad::prepare_call(qint64 now_ns) {
+    int account_index = SipCallLoad::next_account();
+    if (account_index < 0) {
+        return nullptr;
+    }
+
+    //Only the object is created here, nothing is sent to PJSIP yet
+    SipCall* call = new SipCall(*m_machine->load_account(account_index));
+    call->m_link = m_link;
+    call->m_dispatcher = m_machine->dispatcher();
+    call->m_serial = m_next_serial++;
+    call->m_delete_on_disconnect = true;
+    m_machine->apply_media(call, true);
+
+    //The slot exists before the INVITE, so no state of the call can arrive before it
+    Slot& slot = m_slots[call->m_serial];
+    slot.call = call;
+    slot.invite_ns = now_ns;
+    m_metrics.attempted++;
+    m_active++;
+    return call;
+}
+
+void SipCallLoad::place_call(SipCall* call) {
+    quint32 serial = call->m_serial;
+    int call_id = PJSUA_INVALID_ID;
+    try {
+        call->makeCall("sip:" + m_config.destination.toStdString(), m_machine->call_param());
+        call_id = call->getId();
+    } catch (pj::Error& err) {
+        qWarning() << "Load-call creation error:" << err.info().c_str();
+        //Without a call-id there is no DISCONNECTED which could delete the call
+        delete call;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_slots.count(serial)) {
+            SipCallLoad::release(serial);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_slots.find(serial);
+        if (it != m_slots.end()) {
+            it->second.call_id = call_id;
+        }
+    }
+    call->release_creator();
+}
+
+void SipCallLoad::hangup_call(int call_id, SipCall* call) {
+    //The call may already have deleted itself and its id may belong to another call now:
+    //PJSIP keeps the pjsua2-object as user-data of the id, so it is only hung up while they match
+    if (call_id < 0 || pjsua_call_get_user_data(call_id) != call) {
+        return;
+    }
+    pj_str_t reason = pj_str(const_cast<char*>("Normal call clearing"));
+    if (pjsua_call_hangup(call_id, 0, &reason, nullptr) != PJ_SUCCESS) {
+        qWarning() << "Load-call hangup failed:" << call_id;
+    }
+}
+
+int SipCallLoad::next_account() {
+    //Round-robin over the registered accounts
+    int count = m_machine->load_account_count();
+    for (int i = 0; i < count; ++i) {
+        int index = (m_next_account + i) % count;
+        if (m_machine->load_account_registered(index)) {
+            m_next_account = (index + 1) % count;
+            return index;
+        }
+    }
+    return -1;
+}
+
+void SipCallLoad::release(quint32 serial) {
+    auto it = m_slots.find(serial);
+    if (!it->second.answered) {
+        m_metrics.failed++;
+    }
+    m_slots.erase(it);
+    m_active--;
+}
+
+void SipCallLoad::detach() {
+    if (!m_link) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_link->mutex);
+    m_link->observer = nullptr;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipcallload.h/cpp:
+ *The SipCallLoad-Class places calls over the load-accounts of the
+ *SipMachine with a configured rate (calls per second) and a limit of
+ *parallel calls. Every call lives in a slot keyed by its serial, the state
+ *changes of the calls are measured and reported as metrics: setup-latency
+ *(INVITE to 18x/200), success-ratio and reached rate.
+ *The calls delete themselves when they are disconnected (see sipcall.h/cpp),
+ *the slots only point to them. The slot-mutex is never held while PJSIP
+ *sends an INVITE or BYE, so the handler-threads delivering the call-states
+ *are not blocked by the call-setup.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPCALLLOAD_H
+#define SIPCALLLOAD_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sipmachine.h"
+
+struct CallLoadConfig {
+    QString destination;
+    double cps = 1.0;
+    int max_concurrent = 10;    //at most PJSUA_MAX_CALLS, a compile-time option of PJSIP (32 in a stock build)
+    quint64 total_calls = 0;    //0 = until stop()
+    int hold_ms = 10000;        //connected calls are cleared after this time
+};
+
+struct CallLoadMetrics {
+    quint64 attempted = 0;
+    quint64 ringing = 0;        //18x received
+    quint64 answered = 0;       //200 received
+    quint64 failed = 0;         //cleared before 200 or rejected
+    int active = 0;
+    double ringing_mean_ms = 0.0;
+    double ringing_max_ms = 0.0;
+    double answer_mean_ms = 0.0;
+    double answer_max_ms = 0.0;
+    double success_ratio = 0.0; //answered / finished setups
+    double cps = 0.0;           //attempts per second since the last report
+};
+
+class SipCallLoad : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SipCallLoad(SipMachine* sip_machine, QObject* parent = nullptr);
+    ~SipCallLoad();
+
+    bool start(const CallLoadConfig& config);
+    void stop();
+    bool is_running() const;
+    CallLoadMetrics metrics() const;
+
+signals:
+    void metrics_updated(const CallLoadMetrics& metrics);
+    void finished();
+
+public slots:
+    //Invoked out of SipCall::onCallState, queued or directly on a handler-thread
+    void on_call_state(int call_id, quint32 serial, int state, int status_code);
+
+private slots:
+    void tick();
+    void report();
+
+private:
+    struct Slot {
+        SipCall* call = nullptr;    //not owned, only compared with the user-data of PJSIP
+        int call_id = PJSUA_INVALID_ID;
+        qint64 invite_ns = 0;
+        qint64 hangup_ns = 0;   //0 = not connected yet
+        bool ringing = false;
+        bool answered = false;
+    };
+
+    //Called with m_mutex held, the INVITE is sent afterwards by place_call()
+    SipCall* prepare_call(qint64 now_ns);
+    //Called without m_mutex
+    void place_call(SipCall* call);
+    void hangup_call(int call_id, SipCall* call);
+    int next_account();
+    void release(quint32 serial);
+    void detach();
+
+    SipMachine* m_machine;
+    CallLoadConfig m_config;
+    mutable std::mutex m_mutex;     //slots and metrics, the call-events may come from handler-threads
+    QTimer m_tick_timer;
+    QTimer m_report_timer;
+    QElapsedTimer m_clock;
+
+    //Keyed by the serial of the call, which (unlike the call-id) is never reused
+    std::unordered_map<quint32, Slot> m_slots;
+    std::shared_ptr<SipCallLink> m_link;
+    quint32 m_next_serial = 1;
+    int m_active = 0;
+    int m_next_account = 0;
+    qint64 m_next_call_ns = 0;
+    qint64 m_interval_ns = 0;
+
+    CallLoadMetrics m_metrics;
+    double m_ringing_sum_ms = 0.0;
+    double m_answer_sum_ms = 0.0;
+    quint64 m_reported_attempts = 0;
+    qint64 m_report_ns = 0;
+};
+
+#endif // SIPCALLLOAD_H
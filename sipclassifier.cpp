@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipclassifier.h/cpp:
+ *The SipClassifier-Class classifies a PJSIP-logentry in one pass. It only
+ *reads the PJSIP log-line (TX/RX, Request/Response, transport and peer),
+ *the SIP start-line and the header-section, the body is never touched.
+ *The result is the compact SipMessageInfo-struct, which references the
+ *interesting headers (Call-ID, CSeq, top Via) by byte-offsets into the
+ *SIP-message instead of copying them.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipclassifier.h"
+
+#include <cstring>
+
+static const char* const method_names[] = {
+    "UNKNOWN", "REGISTER", "INVITE", "ACK", "BYE", "CANCEL", "OPTIONS", "UPDATE",
+    "PRACK", "INFO", "REFER", "NOTIFY", "SUBSCRIBE", "MESSAGE", "PUBLISH"
+};
+
+static inline bool starts_with(const char* p, const char* end, const char* literal) {
+    size_t size = strlen(literal);
+    return size_t(end - p) >= size && memcmp(p, literal, size) == 0;
+}
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline char to_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+static bool equals_nocase(const char* p, size_t size, const char* literal) {
+    if (strlen(literal) != size) {
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (to_lower(p[i]) != to_lower(literal[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char* find(const char* p, const char* end, const char* literal) {
+    size_t size = strlen(literal);
+    for (; p + size <= end; ++p) {
+        if (*p == literal[0] && memcmp(p, literal, size) == 0) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+static SipSpan make_span(const char* base, const char* begin, const char* end) {
+    SipSpan span;
+    size_t offset = size_t(begin - base);
+    size_t length = size_t(end - begin);
+    if (offset + length <= 0xFFFF) {
+        span.offset = quint16(offset);
+        span.length = quint16(length);
+    }
+    return span;
+}
+
+const char* SipMessageInfo::method_name(Method method) {
+    return method_names[method];
+}
+
+SipMessageInfo::Method SipClassifier::parse_method(const char* text, size_t size) {
+    for (int i = SipMessageInfo::Register; i <= SipMessageInfo::Publish; ++i) {
+        if (strlen(method_names[i]) == size && memcmp(method_names[i], text, size) == 0) {
+            return SipMessageInfo::Method(i);
+        }
+    }
+    return SipMessageInfo::UnknownMethod;
+}
+
+bool SipClassifier::classify(const char* data, size_t size, SipMessageInfo& info, size_t& message_offset, size_t& message_size) {
+    const char* end = data + size;
+    const char* line_end = static_cast<const char*>(memchr(data, '\n', size));
+    if (!line_end) {
+        return false;
+    }
+
+    //PJSIP log-line: "<time> <sender> .TX 512 bytes Request msg INVITE/cseq=1 (tdta..) to TCP 1.2.3.4:5060:"
+    const char* marker = nullptr;
+    for (const char* p = data; p + 3 < line_end; ++p) {
+        if ((p[0] == 'T' || p[0] == 'R') && p[1] == 'X' && p[2] == ' ' && is_digit(p[3])
+            && (p == data || p[-1] == ' ' || p[-1] == '.')) {
+            marker = p;
+            break;
+        }
+    }
+    if (!marker) {
+        return false;
+    }
+
+    info = SipMessageInfo();
+    info.direction = marker[0] == 'T' ? SipMessageInfo::Tx : SipMessageInfo::Rx;
+
+    const char* p = marker + 3;
+    while (p < line_end && is_digit(*p)) {
+        p++;
+    }
+    if (starts_with(p, line_end, " bytes Request msg ")) {
+        info.is_request = true;
+    } else if (!starts_with(p, line_end, " bytes Response msg ")) {
+        return false;
+    }
+
+    const char* peer = find(p, line_end, info.direction == SipMessageInfo::Tx ? " to " : " from ");
+    if (peer) {
+        peer += info.direction == SipMessageInfo::Tx ? 4 : 6;
+        if (starts_with(peer, line_end, "UDP")) {
+            info.transport = SipMessageInfo::Udp;
+        } else if (starts_with(peer, line_end, "TCP")) {
+            info.transport = SipMessageInfo::Tcp;
+        } else if (starts_with(peer, line_end, "TLS")) {
+            info.transport = SipMessageInfo::Tls;
+        } else {
+            info.transport = SipMessageInfo::OtherTransport;
+        }
+
+        //"1.2.3.4:5060:" or "[::1]:5060:"
+        const char* host = static_cast<const char*>(memchr(peer, ' ', size_t(line_end - peer)));
+        const char* host_end = line_end;
+        while (host_end > peer && (host_end[-1] == ':' || host_end[-1] == '\r' || host_end[-1] == ' ')) {
+            host_end--;
+        }
+        if (host && ++host < host_end) {
+            const char* colon = host_end;
+            while (colon > host && colon[-1] != ':') {
+                colon--;
+            }
+            if (colon > host) {
+                int port = 0;
+                for (const char* d = colon; d < host_end && is_digit(*d); ++d) {
+                    port = port * 10 + (*d - '0');
+                }
+                info.remote_port = quint16(port);
+                host_end = colon - 1;
+            }
+            if (*host == '[' && host_end > host && host_end[-1] == ']') {
+                host++;
+                host_end--;
+            }
+            size_t length = qMin(size_t(host_end - host), sizeof(info.remote_ip) - 1);
+            memcpy(info.remote_ip, host, length);
+            info.remote_ip[length] = '\0';
+        }
+    }
+
+    //SIP-message follows the log-line and is terminated by "--end msg--"
+    const char* message = line_end + 1;
+    const char* message_end = find(message, end, "\n--end msg--");
+    if (!message_end) {
+        message_end = end;
+    }
+    message_offset = size_t(message - data);
+    message_size = size_t(message_end - message);
+
+    //Start-line
+    const char* line = message;
+    line_end = static_cast<const char*>(memchr(line, '\n', size_t(message_end - line)));
+    if (!line_end) {
+        return true;
+    }
+    if (starts_with(line, line_end, "SIP/2.0 ")) {
+        const char* code = line + 8;
+        for (int i = 0; i < 3 && code + i < line_end && is_digit(code[i]); ++i) {
+            info.status_code = quint16(info.status_code * 10 + (code[i] - '0'));
+        }
+    } else {
+        const char* space = static_cast<const char*>(memchr(line, ' ', size_t(line_end - line)));
+        if (space) {
+            info.method = SipClassifier::parse_method(line, size_t(space - line));
+        }
+    }
+
+    //Header-section up to the empty line, the body is not scanned
+    for (line = line_end + 1; line < message_end; line = line_end + 1) {
+        line_end = static_cast<const char*>(memchr(line, '\n', size_t(message_end - line)));
+        if (!line_end) {
+            line_end = message_end;
+        }
+        const char* content_end = line_end;
+        if (content_end > line && content_end[-1] == '\r') {
+            content_end--;
+        }
+        if (content_end == line) {
+            if (line_end < message_end) {
+                info.body = make_span(message, line_end + 1, message_end);
+            }
+            break;
+        }
+        if (*line == ' ' || *line == '\t') {
+            continue;   //folded header-line
+        }
+
+        const char* colon = static_cast<const char*>(memchr(line, ':', size_t(content_end - line)));
+        if (!colon) {
+            continue;
+        }
+        const char* name_end = colon;
+        while (name_end > line && (name_end[-1] == ' ' || name_end[-1] == '\t')) {
+            name_end--;
+        }
+        const char* value = colon + 1;
+        while (value < content_end && (*value == ' ' || *value == '\t')) {
+            value++;
+        }
+        size_t name_size = size_t(name_end - line);
+
+        if (equals_nocase(line, name_size, "Call-ID") || equals_nocase(line, name_size, "i")) {
+            info.call_id = make_span(message, value, content_end);
+        } else if (equals_nocase(line, name_size, "CSeq")) {
+            info.cseq = make_span(message, value, content_end);
+            if (!info.is_request) {
+                const char* method = value;
+                while (method < content_end && (is_digit(*method) || *method == ' ')) {
+                    method++;
+                }
+                info.method = SipClassifier::parse_method(method, size_t(content_end - method));
+            }
+        } else if (info.via_host.is_empty() && (equals_nocase(line, name_size, "Via") || equals_nocase(line, name_size, "v"))) {
+            //"SIP/2.0/TCP host:port;branch=..."
+            const char* host = static_cast<const char*>(memchr(value, ' ', size_t(content_end - value)));
+            if (host) {
+                while (host < content_end && *host == ' ') {
+                    host++;
+                }
+                const char* host_end = host;
+                if (host < content_end && *host == '[') {
+                    host++;
+                    while (host_end < content_end && *host_end != ']') {
+                        host_end++;
+                    }
+                } else {
+                    while (host_end < content_end && *host_end != ':' && *host_end != ';' && *host_end != ' ') {
+                        host_end++;
+                    }
+                }
+                info.via_host = make_span(message, host, host_end);
+            }
+        }
+    }
+    return true;
+}
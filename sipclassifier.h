@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipclassifier.h/cpp:
+ *The SipClassifier-Class classifies a PJSIP-logentry in one pass. It only
+ *reads the PJSIP log-line (TX/RX, Request/Response, transport and peer),
+ *the SIP start-line and the header-section, the body is never touched.
+ *The result is the compact SipMessageInfo-struct, which references the
+ *interesting headers (Call-ID, CSeq, top Via) by byte-offsets into the
+ *SIP-message instead of copying them.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPCLASSIFIER_H
+#define SIPCLASSIFIER_H
+
+#include <QtGlobal>
+
+#include <cstddef>
+
+//Byte-range inside the SIP-message, length 0 = not present
+struct SipSpan {
+    quint16 offset = 0;
+    quint16 length = 0;
+
+    bool is_empty() const { return length == 0; }
+};
+
+struct SipMessageInfo {
+    enum Direction : quint8 { Tx, Rx };
+    enum Transport : quint8 { Udp, Tcp, Tls, OtherTransport };
+    enum Method : quint8 {
+        UnknownMethod, Register, Invite, Ack, Bye, Cancel, Options, Update,
+        Prack, Info, Refer, Notify, Subscribe, Message, Publish
+    };
+
+    Direction direction = Tx;
+    Transport transport = Udp;
+    bool is_request = false;
+    Method method = UnknownMethod;  //for responses the method out of CSeq
+    quint16 status_code = 0;        //0 for requests
+    quint16 remote_port = 0;
+    char remote_ip[48] = {};        //peer out of the PJSIP log-line
+    SipSpan via_host;               //sent-by host of the top Via
+    SipSpan call_id;
+    SipSpan cseq;
+    SipSpan body;                   //after the empty line, empty without body
+
+    static const char* method_name(Method method);
+};
+
+class SipClassifier {
+
+public:
+    //Returns false for every logentry which is no SIP-message. On success
+    //message_offset/message_size locate the SIP-message inside data, all
+    //spans of info are relative to this SIP-message.
+    static bool classify(const char* data, size_t size, SipMessageInfo& info, size_t& message_offset, size_t& message_size);
+
+    static SipMessageInfo::Method parse_method(const char* text, size_t size);
+};
+
+#endif // SIPCLASSIFIER_H
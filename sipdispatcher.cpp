@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipdispatcher.h/cpp:
+ *The SipDispatcher-Class is a pool of handler-threads for the call- and
+ *registration-events of PJSIP. The PJSIP-workers only queue the event,
+ *the handling runs on the handler-thread selected by the key (call-id or
+ *account), so the events of one call keep their order and the GUI-thread
+ *is not involved.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipdispatcher.h"
+
+#include <QString>
+
+SipDispatcher::SipDispatcher(int thread_count, ThreadInit thread_init) : m_running(true) {
+    thread_count = qMax(1, thread_count);
+    for (int i = 0; i < thread_count; ++i) {
+        m_handlers.emplace_back(new Handler());
+    }
+
+    for (int i = 0; i < thread_count; ++i) {
+        Handler* handler = m_handlers[size_t(i)].get();
+        handler->thread = QThread::create([this, handler, i, thread_init]() {
+            if (thread_init) {
+                thread_init(i);
+            }
+            SipDispatcher::run(*handler);
+        });
+        handler->thread->setObjectName(QString("SipHandler%1").arg(i));
+        handler->thread->start();
+    }
+}
+
+SipDispatcher::~SipDispatcher() {
+    //Already queued events are still handled before the threads end
+    m_running.store(false);
+    for (std::unique_ptr<Handler>& handler : m_handlers) {
+        {
+            std::lock_guard<std::mutex> lock(handler->mutex);
+        }
+        handler->wakeup.notify_one();
+    }
+    for (std::unique_ptr<Handler>& handler : m_handlers) {
+        handler->thread->wait();
+        delete handler->thread;
+    }
+}
+
+void SipDispatcher::post(int key, Task task) {
+    Handler& handler = *m_handlers[unsigned(key) % unsigned(m_handlers.size())];
+    {
+        std::lock_guard<std::mutex> lock(handler.mutex);
+        handler.queue.push_back(std::move(task));
+    }
+    handler.wakeup.notify_one();
+}
+
+int SipDispatcher::thread_count() const {
+    return int(m_handlers.size());
+}
+
+void SipDispatcher::run(Handler& handler) {
+    std::deque<Task> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(handler.mutex);
+            handler.wakeup.wait(lock, [this, &handler]() {
+                return !handler.queue.empty() || !m_running.load();
+            });
+            if (handler.queue.empty()) {
+                return;
+            }
+            //The whole queue is taken at once, the PJSIP-workers are not blocked while handling
+            batch.swap(handler.queue);
+        }
+
+        for (Task& task : batch) {
+            task();
+        }
+        batch.clear();
+    }
+}
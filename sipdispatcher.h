@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipdispatcher.h/cpp:
+ *The SipDispatcher-Class is a pool of handler-threads for the call- and
+ *registration-events of PJSIP. The PJSIP-workers only queue the event,
+ *the handling runs on the handler-thread selected by the key (call-id or
+ *account), so the events of one call keep their order and the GUI-thread
+ *is not involved.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPDISPATCHER_H
+#define SIPDISPATCHER_H
+
+#include <QThread>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class SipDispatcher {
+
+public:
+    using Task = std::function<void()>;
+    using ThreadInit = std::function<void(int index)>;
+
+    //thread_init runs first on every handler-thread, e.g. to register the thread at PJSIP
+    SipDispatcher(int thread_count, ThreadInit thread_init);
+    ~SipDispatcher();
+
+    //Thread-safe, tasks with the same key run in order on the same handler-thread
+    void post(int key, Task task);
+    int thread_count() const;
+
+private:
+    struct Handler {
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::deque<Task> queue;
+        QThread* thread = nullptr;
+    };
+
+    void run(Handler& handler);
+
+    std::vector<std::unique_ptr<Handler>> m_handlers;
+    std::atomic<bool> m_running;
+};
+
+#endif // SIPDISPATCHER_H
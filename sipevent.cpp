@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipevent.h/cpp:
+ *The SipEvent-struct is one captured SIP-message for the FlowChart. It
+ *keeps the raw SIP-message in one implicitly shared, never modified
+ *buffer together with the SipMessageInfo of the SipClassifier, whose
+ *offset-ranges point into this buffer. Header, IPs and body are only
+ *views into the buffer, QStrings are built on demand for the ui.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipevent.h"
+
+//Local side is the sent-by of the top Via, remote side comes from the PJSIP log-line
+
+QString SipEvent::source_ip() const {
+    if (info.direction == SipMessageInfo::Tx) {
+        return QString::fromLatin1(raw.constData() + info.via_host.offset, info.via_host.length);
+    }
+    return QString::fromLatin1(info.remote_ip);
+}
+
+QString SipEvent::destination_ip() const {
+    if (info.direction == SipMessageInfo::Tx) {
+        return QString::fromLatin1(info.remote_ip);
+    }
+    return QString::fromLatin1(raw.constData() + info.via_host.offset, info.via_host.length);
+}
+
+QString SipEvent::message_header() const {
+    if (info.is_request) {
+        return QString::fromLatin1(SipMessageInfo::method_name(info.method));
+    }
+    return QString("%1/%2").arg(info.status_code).arg(SipMessageInfo::method_name(info.method));
+}
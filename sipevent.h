@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipevent.h/cpp:
+ *The SipEvent-struct is one captured SIP-message for the FlowChart. It
+ *keeps the raw SIP-message in one implicitly shared, never modified
+ *buffer together with the SipMessageInfo of the SipClassifier, whose
+ *offset-ranges point into this buffer. Header, IPs and body are only
+ *views into the buffer, QStrings are built on demand for the ui.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPEVENT_H
+#define SIPEVENT_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "sipclassifier.h"
+
+struct SipEvent {
+    QByteArray raw;         //complete SIP-message, shared and never modified
+    SipMessageInfo info;    //spans are offsets into raw
+
+    bool is_request() const { return info.is_request; }
+
+    //View without copy, only valid as long as raw lives
+    QByteArray view(const SipSpan& span) const {
+        return QByteArray::fromRawData(raw.constData() + span.offset, span.length);
+    }
+
+    QString source_ip() const;
+    QString destination_ip() const;
+    QString message_header() const;
+    QString sip_message() const { return QString::fromUtf8(raw); }
+};
+
+#endif // SIPEVENT_H
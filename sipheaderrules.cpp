@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipheaderrules.h/cpp:
+ *The SipHeaderRules-Class is the declarative form of the header-
+ *manipulation of outgoing SIP-messages (add/remove/replace a header,
+ *filtered by method and requests/responses). It is read from a JSON-file
+ *and compiled by SipTxPlan into the program the TX-hook runs.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipheaderrules.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+bool SipHeaderRules::is_empty() const {
+    return rules.isEmpty();
+}
+
+//Format of a rule-file (JSON), methods and messages are optional:
+//{
+//  "rules": [
+//    { "action": "remove", "header": "Supported", "methods": ["INVITE", "UPDATE"] },
+//    { "action": "replace", "header": "Allow", "value": "INVITE, ACK, BYE, CANCEL", "messages": "requests" },
+//    { "action": "add", "header": "P-Early-Media", "value": "supported", "methods": ["INVITE"], "messages": "both" }
+//  ]
+//}
+bool SipHeaderRules::load(const QString& path, SipHeaderRules& rules) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open header-rules:" << path;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (doc.isNull() || !doc.isObject()) {
+        qWarning() << "Invalid header-rules" << path << ":" << error.errorString();
+        return false;
+    }
+
+    rules = SipHeaderRules();
+    const QJsonArray entries = doc.object().value("rules").toArray();
+    for (const QJsonValue& value : entries) {
+        QJsonObject entry = value.toObject();
+        SipHeaderRule rule;
+        rule.header = entry.value("header").toString().trimmed();
+        rule.value = entry.value("value").toString();
+        if (rule.header.isEmpty()) {
+            qWarning() << "Header-rule without header";
+            return false;
+        }
+
+        QString action = entry.value("action").toString();
+        if (action == "add") {
+            rule.action = SipHeaderRule::Add;
+        } else if (action == "remove") {
+            rule.action = SipHeaderRule::Remove;
+        } else if (action == "replace") {
+            rule.action = SipHeaderRule::Replace;
+        } else {
+            qWarning() << "Unknown header-rule action:" << action;
+            return false;
+        }
+
+        const QJsonArray methods = entry.value("methods").toArray();
+        for (const QJsonValue& method : methods) {
+            rule.methods.push_back(method.toString().toUpper());
+        }
+
+        QString messages = entry.value("messages").toString("both");
+        if (messages == "requests") {
+            rule.responses = false;
+        } else if (messages == "responses") {
+            rule.requests = false;
+        } else if (messages != "both") {
+            qWarning() << "Unknown header-rule messages:" << messages;
+            return false;
+        }
+        rules.rules.push_back(rule);
+    }
+
+    return true;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipheaderrules.h/cpp:
+ *The SipHeaderRules-Class is the declarative form of the header-
+ *manipulation of outgoing SIP-messages (add/remove/replace a header,
+ *filtered by method and requests/responses). It is read from a JSON-file
+ *and compiled by SipTxPlan into the program the TX-hook runs.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPHEADERRULES_H
+#define SIPHEADERRULES_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct SipHeaderRule {
+    enum Action { Add, Remove, Replace };
+
+    Action action = Add;
+    QString header;
+    QString value;              //Add/Replace
+    QStringList methods;        //empty = every method, for responses the method out of CSeq
+    bool requests = true;
+    bool responses = true;
+};
+
+class SipHeaderRules {
+
+public:
+    QVector<SipHeaderRule> rules;
+
+    bool is_empty() const;
+
+    static bool load(const QString& path, SipHeaderRules& rules);
+};
+
+#endif // SIPHEADERRULES_H
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file siphistory.h/cpp:
+ *The SipHistory-Class stores all captured SIP-messages of the FlowChart
+ *with bounded memory. Every message is appended to on-disk segment-files
+ *(append-only, in a temporary directory) and an offset-index per row is
+ *kept. Only the newest messages stay in memory, older rows are paged back
+ *in on demand through a memory-mapping of their segment, so the resident
+ *memory stays flat even for multi-day runs. Only the segment written to
+ *and the one mapped are kept open. The disk is bounded too: beyond
+ *max_segments the oldest segment is deleted and its rows drop out of the
+ *history (at() returns an empty event for them, the row-numbers stay).
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "siphistory.h"
+
+#include <QDebug>
+#include <QDir>
+
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<SipMessageInfo>::value, "SipMessageInfo is written raw to disk");
+
+SipHistory::SipHistory() : m_dir(QDir::tempPath() + "/RTP-Generator-XXXXXX") {
+    m_spill = m_dir.isValid();
+    if (!m_spill) {
+        qWarning() << "No SIP-history directory, keeping all messages in memory";
+    }
+}
+
+SipHistory::~SipHistory() {
+    SipHistory::unmap();
+}
+
+void SipHistory::append(const SipEvent& event) {
+    if (m_spill) {
+        Location location;
+        if (SipHistory::write_record(event, location)) {
+            m_index.push_back(location);
+        } else {
+            qWarning() << "SIP-history write failed, keeping all messages in memory";
+            m_spill = false;
+        }
+    }
+
+    m_window.push_back(event);
+    m_size++;
+
+    //Without a complete on-disk index nothing may leave the memory
+    if (m_spill && int(m_index.size()) == m_size && int(m_window.size()) > memory_window) {
+        m_window.pop_front();
+        m_window_first++;
+    }
+}
+
+SipEvent SipHistory::at(int row) const {
+    if (row >= m_window_first) {
+        return m_window[size_t(row - m_window_first)];
+    }
+
+    const Location& location = m_index[size_t(row)];
+    if (location.segment < m_first_segment) {
+        return SipEvent();
+    }
+    const uchar* base = SipHistory::map_segment(location.segment, location.offset + qint64(sizeof(RecordHeader)));
+    SipEvent event;
+    if (!base) {
+        return event;
+    }
+
+    RecordHeader header;
+    memcpy(&header, base + location.offset, sizeof(header));
+    base = SipHistory::map_segment(location.segment, location.offset + qint64(sizeof(header)) + header.size);
+    if (!base) {
+        return event;
+    }
+    //Copied out of the mapping, the mapping may move to another segment
+    event.info = header.info;
+    event.raw = QByteArray(reinterpret_cast<const char*>(base + location.offset + sizeof(header)), int(header.size));
+    return event;
+}
+
+bool SipHistory::write_record(const SipEvent& event, Location& location) {
+    qint64 record_size = qint64(sizeof(RecordHeader)) + event.raw.size();
+    if (m_segments.empty() || m_write_offset + record_size > segment_size) {
+        //The finished segment is only reopened when an old row is read
+        if (!m_segments.empty() && !(m_mapped && m_mapped_segment == m_segments.size() - 1)) {
+            m_segments.back()->close();
+        }
+        QString path = m_dir.filePath(QString("segment-%1.bin").arg(m_segments.size(), 5, 10, QChar('0')));
+        std::unique_ptr<QFile> file(new QFile(path));
+        if (!file->open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+            return false;
+        }
+        m_segments.push_back(std::move(file));
+        m_write_offset = 0;
+
+        if (int(m_segments.size() - m_first_segment) > max_segments) {
+            SipHistory::drop_oldest_segment();
+        }
+    }
+
+    RecordHeader header;
+    header.info = event.info;
+    header.size = quint32(event.raw.size());
+
+    QFile* file = m_segments.back().get();
+    if (file->write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header))
+        || file->write(event.raw) != event.raw.size()) {
+        return false;
+    }
+
+    location.segment = quint32(m_segments.size() - 1);
+    location.offset = quint32(m_write_offset);
+    m_write_offset += record_size;
+    return true;
+}
+
+const uchar* SipHistory::map_segment(quint32 segment, qint64 end) const {
+    if (m_mapped && m_mapped_segment == segment && m_mapped_size >= end) {
+        return m_mapped;
+    }
+
+    SipHistory::unmap();
+
+    //The newest segment is still growing, so it is remapped with its current size
+    QFile* file = m_segments[segment].get();
+    if (!file->isOpen() && !file->open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    file->flush();
+    qint64 size = file->size();
+    if (size < end) {
+        return nullptr;
+    }
+    m_mapped = file->map(0, size);
+    m_mapped_segment = segment;
+    m_mapped_size = m_mapped ? size : 0;
+    return m_mapped;
+}
+
+void SipHistory::unmap() const {
+    if (!m_mapped) {
+        return;
+    }
+    QFile* file = m_segments[m_mapped_segment].get();
+    file->unmap(m_mapped);
+    m_mapped = nullptr;
+    m_mapped_size = 0;
+    //Only the segment written to stays open
+    if (m_mapped_segment + 1 != m_segments.size()) {
+        file->close();
+    }
+}
+
+void SipHistory::drop_oldest_segment() {
+    if (m_mapped && m_mapped_segment == m_first_segment) {
+        SipHistory::unmap();
+    }
+    m_segments[m_first_segment]->remove();
+    m_segments[m_first_segment].reset();
+    qDebug() << "SIP-history: segment" << m_first_segment << "removed, its rows dropped out";
+    m_first_segment++;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file siphistory.h/cpp:
+ *The SipHistory-Class stores all captured SIP-messages of the FlowChart
+ *with bounded memory. Every message is appended to on-disk segment-files
+ *(append-only, in a temporary directory) and an offset-index per row is
+ *kept. Only the newest messages stay in memory, older rows are paged back
+ *in on demand through a memory-mapping of their segment, so the resident
+ *memory stays flat even for multi-day runs. Only the segment written to
+ *and the one mapped are kept open. The disk is bounded too: beyond
+ *max_segments the oldest segment is deleted and its rows drop out of the
+ *history (at() returns an empty event for them, the row-numbers stay).
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPHISTORY_H
+#define SIPHISTORY_H
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "sipevent.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+class SipHistory {
+
+public:
+    //Rows kept in memory, everything older is only on disk
+    static const int memory_window = 10000;
+    static const qint64 segment_size = 64 * 1024 * 1024;
+    //Segments kept on disk (2 GB), older rows are dropped
+    static const int max_segments = 32;
+
+    SipHistory();
+    ~SipHistory();
+
+    void append(const SipEvent& event);
+    int size() const { return m_size; }
+    //Rows outside of the memory-window are read back from disk, dropped rows are empty
+    SipEvent at(int row) const;
+
+private:
+    struct Location {
+        quint32 segment;
+        quint32 offset;
+    };
+
+    struct RecordHeader {
+        SipMessageInfo info;
+        quint32 size;
+    };
+
+    bool write_record(const SipEvent& event, Location& location);
+    const uchar* map_segment(quint32 segment, qint64 end) const;
+    void unmap() const;
+    void drop_oldest_segment();
+
+    std::deque<SipEvent> m_window;
+    int m_window_first = 0;
+    int m_size = 0;
+
+    QTemporaryDir m_dir;
+    bool m_spill = false;
+    std::vector<Location> m_index;
+    std::vector<std::unique_ptr<QFile>> m_segments;     //null = dropped, the index stays the segment-number
+    quint32 m_first_segment = 0;
+    qint64 m_write_offset = 0;
+
+    //Only one segment is mapped at a time
+    mutable quint32 m_mapped_segment = 0;
+    mutable uchar* m_mapped = nullptr;
+    mutable qint64 m_mapped_size = 0;
+};
+
+#endif // SIPHISTORY_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipindex.h/cpp:
+ *The SipIndex-Class is an incremental index over the rows of the captured
+ *SIP-messages: Call-ID -> rows. Every appended message updates the index
+ *in O(1) and only a new dialog copies its key, so the dialog-filter of the
+ *FlowChart is just a lookup.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipindex.h"
+
+static const SipIndex::Rows no_rows;
+
+void SipIndex::add(int row, const SipEvent& event) {
+    const SipMessageInfo& info = event.info;
+    if (info.call_id.is_empty()) {
+        return;
+    }
+    //Only a new key is copied, known dialogs just get the row appended
+    QByteArray call_id = event.view(info.call_id);
+    auto it = m_call_ids.find(call_id);
+    if (it == m_call_ids.end()) {
+        it = m_call_ids.insert(QByteArray(call_id.constData(), call_id.size()), Rows());
+    }
+    it->push_back(row);
+}
+
+const SipIndex::Rows& SipIndex::rows_for_call_id(const QByteArray& call_id) const {
+    auto it = m_call_ids.constFind(call_id);
+    return it == m_call_ids.constEnd() ? no_rows : *it;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file sipindex.h/cpp:
+ *The SipIndex-Class is an incremental index over the rows of the captured
+ *SIP-messages: Call-ID -> rows. Every appended message updates the index
+ *in O(1) and only a new dialog copies its key, so the dialog-filter of the
+ *FlowChart is just a lookup.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPINDEX_H
+#define SIPINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+
+#include "sipevent.h"
+
+#include <vector>
+
+class SipIndex {
+
+public:
+    typedef std::vector<int> Rows;
+
+    //Rows have to be added in ascending order, so every list stays sorted
+    void add(int row, const SipEvent& event);
+
+    const Rows& rows_for_call_id(const QByteArray& call_id) const;
+
+    int dialog_count() const { return int(m_call_ids.size()); }
+
+private:
+    QHash<QByteArray, Rows> m_call_ids;
+};
+
+#endif // SIPINDEX_H
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file siplogring.h/cpp:
+ *The SipLogRing-Class is a bounded lock-free ring of pre-sized log-records
+ *between the PJSIP-threads (many producers, see siplogwriter.h/cpp) and
+ *the GUI-thread (single consumer). Writing never blocks and never
+ *allocates: if the ring is full the record is dropped and counted.
+ *The GUI drains the ring in batches on a timer (see sipmachine.cpp).
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "siplogring.h"
+
+#include <cstring>
+
+SipLogRing::SipLogRing() : m_records(new Record[capacity]) {
+    //A slot is free for write-position n when its sequence is n
+    for (size_t i = 0; i < capacity; ++i) {
+        m_records[i].sequence.store(i, std::memory_order_relaxed);
+        m_records[i].size = 0;
+    }
+}
+
+static void clamp_span(SipSpan& span, size_t size) {
+    if (size_t(span.offset) + span.length > size) {
+        span = SipSpan();
+    }
+}
+
+bool SipLogRing::push(const SipMessageInfo& info, const char* data, size_t size) {
+    size_t pos = m_write_pos.load(std::memory_order_relaxed);
+    Record* record;
+    while (true) {
+        record = &m_records[pos & (capacity - 1)];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+        if (diff == 0) {
+            //Slot is free: claim it, other producers move on to the next one
+            if (m_write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            //The GUI did not drain this slot yet - the ring is full
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_write_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    if (size > record_size) {
+        size = record_size;
+        m_truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+    memcpy(record->data, data, size);
+    record->size = size;
+    record->info = info;
+    //Headers cut off by the truncation are not present anymore
+    clamp_span(record->info.via_host, size);
+    clamp_span(record->info.call_id, size);
+    clamp_span(record->info.cseq, size);
+    clamp_span(record->info.body, size);
+    //Publish the record to the consumer
+    record->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file siplogring.h/cpp:
+ *The SipLogRing-Class is a bounded lock-free ring of pre-sized log-records
+ *between the PJSIP-threads (many producers, see siplogwriter.h/cpp) and
+ *the GUI-thread (single consumer). Writing never blocks and never
+ *allocates: if the ring is full the record is dropped and counted.
+ *The GUI drains the ring in batches on a timer (see sipmachine.cpp).
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPLOGRING_H
+#define SIPLOGRING_H
+
+#include <QByteArray>
+
+#include "sipclassifier.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class SipLogRing {
+
+public:
+    //Has to be a power of two
+    static const size_t capacity = 1024;
+    //Longer messages are truncated, large enough for SIP with SDP
+    static const size_t record_size = 8192;
+
+    SipLogRing();
+
+    //Called from any PJSIP-thread, returns false if the record was dropped
+    bool push(const SipMessageInfo& info, const char* data, size_t size);
+
+    //Only called from the GUI-thread, calls handler(const SipMessageInfo&, const QByteArray&)
+    //for every record and returns the number of drained records
+    template<typename Handler>
+    size_t drain(Handler handler, size_t max_records = capacity) {
+        size_t count = 0;
+        while (count < max_records) {
+            Record& record = m_records[m_read_pos & (capacity - 1)];
+            if (record.sequence.load(std::memory_order_acquire) != m_read_pos + 1) {
+                break;
+            }
+            handler(record.info, QByteArray(record.data, int(record.size)));
+            //Free the slot for the next round of the producers
+            record.sequence.store(m_read_pos + capacity, std::memory_order_release);
+            m_read_pos++;
+            count++;
+        }
+        return count;
+    }
+
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    quint64 truncated() const { return m_truncated.load(std::memory_order_relaxed); }
+
+private:
+    struct Record {
+        std::atomic<size_t> sequence;
+        SipMessageInfo info;
+        size_t size;
+        char data[record_size];
+    };
+
+    std::unique_ptr<Record[]> m_records;
+    alignas(64) std::atomic<size_t> m_write_pos{0};
+    alignas(64) size_t m_read_pos = 0;
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<quint64> m_truncated{0};
+};
+
+#endif // SIPLOGRING_H
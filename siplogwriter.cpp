@@ -23,8 +23,11 @@
  *This Class is derived from the original PJSIP logwriter and has the
  *responsibility to catch the PJSIP-logmessages, classify them and hand
  *them over to the FlowChart-Object.
- *Handover is done by a signal and the characteristics for deciding whether
- *or not handover it is done by the Payload - only SIP-Messages are forwarded.
+ *Handover is done through a lock-free SipLogRing (see siplogring.h/cpp),
+ *which the GUI-thread drains on a timer, so the PJSIP-threads never block
+ *and the Qt event-loop gets no event per message.
+ *Each logentry is classified in one pass by the SipClassifier (see
+ *sipclassifier.h/cpp) - only SIP-Messages are forwarded.
  *All other PJSIP-message are dropped/ignored.
  *
  *
@@ -46,23 +49,17 @@
 
 
 #include "siplogwriter.h"
+#include "sipclassifier.h"
 
 void SipLogWriter::write(const pj::LogEntry& entry) {
-    std::string message = entry.msg;
-
-    if (message.find("\r\n\r\n") != std::string::npos) {
-        if (
-            message.find("SIP/2.0") != std::string::npos ||
-            message.find("REGISTER") != std::string::npos ||
-            message.find("INVITE") != std::string::npos ||
-            message.find("BYE") != std::string::npos ||
-            message.find("CANCEL") != std::string::npos ||
-            message.find("ACK") != std::string::npos ||
-            message.find("OPTION") != std::string::npos
-            ) {
-            //qDebug().noquote() << "Custom Logwriter:\n" <<  QString::fromStdString(message);
-            emit new_sip_message(QString::fromStdString(message));
-        }
+    //Only the log-line, start-line and headers are read, everything else is ignored
+    SipMessageInfo info;
+    size_t offset = 0;
+    size_t size = 0;
+    if (!SipClassifier::classify(entry.msg.data(), entry.msg.size(), info, offset, size)) {
+        return;
     }
 
+    //Never blocks - if the GUI is behind, the message is dropped and counted
+    m_ring.push(info, entry.msg.data() + offset, size);
 }
@@ -23,8 +23,11 @@
  *This Class is derived from the original PJSIP logwriter and has the
  *responsibility to catch the PJSIP-logmessages, classify them and hand
  *them over to the FlowChart-Object.
- *Handover is done by a signal and the characteristics for deciding whether
- *or not handover it is done by the Payload - only SIP-Messages are forwarded.
+ *Handover is done through a lock-free SipLogRing (see siplogring.h/cpp),
+ *which the GUI-thread drains on a timer, so the PJSIP-threads never block
+ *and the Qt event-loop gets no event per message.
+ *Each logentry is classified in one pass by the SipClassifier (see
+ *sipclassifier.h/cpp) - only SIP-Messages are forwarded.
  *All other PJSIP-message are dropped/ignored.
  *
  *
@@ -50,6 +53,8 @@
 #include <pjsua2.hpp>
 #include <QObject>
 
+#include "siplogring.h"
+
 class SipLogWriter : public QObject,  public pj::LogWriter {
     Q_OBJECT
 
@@ -57,9 +62,10 @@ public:
     SipLogWriter(QObject* parent = nullptr) : QObject(parent) {}
     void write(const pj::LogEntry& entry) override;
 
-signals:
-    void new_sip_message(const QString& message);
+    SipLogRing& ring() { return m_ring; }
 
+private:
+    SipLogRing m_ring;
 };
 
 #endif // SIPLOGWRITER_H
@@ -27,7 +27,12 @@
  *are currently not supported and also not planned to implement.
  *
  *The custom-logwrite SipLogWriter is also instantiated here and maintained in
- *the matching member-variable.
+ *the matching member-variable. Its log-ring is drained here on a timer and
+ *the SIP-messages are handed over in batches.
+ *The media-mode (SipMediaConfig) decides if PJSIP opens a sound-device at
+ *all: Null, File and Tone only use the null-device as clock of the bridge.
+ *With Null the call-ports stay unconnected, so PJSIP sends silence; File/Tone
+ *have one shared player-port which transmits into every call.
  *
  * License:
  * This program is free software; you can redistribute it and/or modify
@@ -50,16 +55,22 @@
 #include <QMetaObject>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+
+#include <atomic>
 
 // Forward: Callback-Signatur für das Modul (korrekt: ein Parameter)
 extern "C" pj_status_t on_tx_request_cb(pjsip_tx_data *tdata);
 
 // Modul-Definition (static in .cpp!)
+// on_tx runs from the lowest priority (highest value) upwards: above TRANSPORT_LAYER the hook rewrites
+// tdata->msg before mod-msg-print encodes it into tdata->buf, which goes on the wire and into the log
 static pjsip_module mod_tx_hook = {
     NULL, NULL,
     { (char*)"mod-tx-hook", 11 },
     -1,
-    PJSIP_MOD_PRIORITY_TRANSPORT_LAYER - 1,
+    PJSIP_MOD_PRIORITY_TRANSPORT_LAYER + 1,
     NULL, NULL, NULL, NULL,
     NULL, NULL,
     &on_tx_request_cb,  // on_tx_request  <- erwartet (pjsip_tx_data*)
@@ -67,94 +78,120 @@ static pjsip_module mod_tx_hook = {
     NULL
 };
 
+// TX-program of the profile, published by SipMachine::publish_tx_plan for the PJSIP-threads
+static std::atomic<const SipTxPlan*> profile_plan(nullptr);
+
 // Implementation des Callbacks (ein Parameter!)
+// Runs for every outgoing message in the PJSIP-thread: no allocation besides the clone, no logging without trace
 extern "C" pj_status_t on_tx_request_cb(pjsip_tx_data *tdata) {
-    qDebug() << "in Callback";
-    if (!tdata || !tdata->msg) return PJ_SUCCESS;
-
-    // Holen des per-Call-Pointers, den wir vor dem makeCall in prm.txOption.mod_data gesetzt haben.
-    SipCall* sip_call = nullptr;
-    if (mod_tx_hook.id >= 0) {
-        sip_call = reinterpret_cast<SipCall*>(tdata->mod_data[mod_tx_hook.id]);
-    }
-
-    // Falls kein SipCall zugeordnet ist, einfach nichts tun
-    if (!sip_call) {
+    if (!tdata || !tdata->msg || mod_tx_hook.id < 0) {
         return PJ_SUCCESS;
     }
-    qDebug() << "SIP-Call gefunden";
-    // Jetzt kannst du wie gewünscht Header anpassen basierend auf Flags in sip_call
-    if (!sip_call->m_rel_not_supported && !sip_call->m_timer_not_supported) {
-        qDebug() << "No Supported";
-        // keine Supported-Header
-        while (pjsip_hdr *hdr = (pjsip_hdr*) pjsip_msg_find_hdr(tdata->msg, PJSIP_H_SUPPORTED, NULL)) {
-            pj_list_erase(hdr);
-        }
+    //Already printed: a retransmission sends the buffer again, the message was rewritten before
+    if (tdata->buf.cur != tdata->buf.start) {
         return PJ_SUCCESS;
     }
 
-    if (sip_call->m_rel_not_supported) {
-        qDebug() << "only timer";
-        while (pjsip_hdr *hdr = (pjsip_hdr*) pjsip_msg_find_hdr(tdata->msg, PJSIP_H_SUPPORTED, NULL)) {
-            pj_list_erase(hdr);
-        }
-        pj_str_t hname = pj_str((char*)"Supported");
-        pj_str_t hval  = pj_str((char*)"timer");
-        pjsip_generic_string_hdr *new_hdr = pjsip_generic_string_hdr_create(tdata->pool, &hname, &hval);
-        pjsip_msg_add_hdr(tdata->msg, (pjsip_hdr*)new_hdr);
-        return PJ_SUCCESS;
+    //Supported-flags of the call-setup and the header-rules, compiled once into one program
+    const SipTxPlan* profile = profile_plan.load(std::memory_order_acquire);
+    if (profile) {
+        profile->apply(tdata);
     }
+    return PJ_SUCCESS;
+}
 
-    if (sip_call->m_timer_not_supported) {
-        qDebug() << "only rel";
-        while (pjsip_hdr *hdr = (pjsip_hdr*) pjsip_msg_find_hdr(tdata->msg, PJSIP_H_SUPPORTED, NULL)) {
-            pj_list_erase(hdr);
-        }
-        pj_str_t hname = pj_str((char*)"Supported");
-        pj_str_t hval  = pj_str((char*)"100rel");
-        pjsip_generic_string_hdr *new_hdr = pjsip_generic_string_hdr_create(tdata->pool, &hname, &hval);
-        pjsip_msg_add_hdr(tdata->msg, (pjsip_hdr*)new_hdr);
-        return PJ_SUCCESS;
+const char* SipTransportConfig::uri_parameter() const {
+    switch (type) {
+    case Udp:
+        return "udp";
+    case Tls:
+        return "tls";
+    case Tcp:
+        break;
     }
+    return "tcp";
+}
 
-    return PJ_SUCCESS;
+quint16 SipTransportConfig::remote_port() const {
+    if (proxy_port != 0) {
+        return proxy_port;
+    }
+    return type == Tls ? 5061 : 5060;
 }
 
 class SipMachine::MyAccount : public pj::Account {
 public:
-    MyAccount(SipMachine* sip_machine) : m_machine(sip_machine) {}
+    MyAccount(SipMachine* sip_machine, int load_index = -1) : m_machine(sip_machine), m_load_index(load_index) {}
     ~MyAccount() {}
 
     virtual void onRegState(pj::OnRegStateParam& reg_state_param) override {
         pj::AccountInfo account_info = getInfo();
         int code = account_info.regStatus;
-        std::string text = account_info.regStatusText;
+        QString text = QString::fromStdString(account_info.regStatusText);
+        m_registered.store(code / 100 == 2, std::memory_order_release);
 
-        if (m_machine) {
+        if (!m_machine) {
+            return;
+        }
+        //With handler-threads the PJSIP-worker only queues the event, otherwise it goes to the GUI-thread
+        SipMachine* machine = m_machine;
+        int index = m_load_index;
+        if (machine->m_dispatcher) {
+            machine->m_dispatcher->post(index, [machine, index, code, text]() {
+                if (index >= 0) {
+                    machine->on_load_account_reg_state(index, code, text);
+                } else {
+                    machine->on_account_reg_state(code, text);
+                }
+            });
+        } else if (index >= 0) {
+            QMetaObject::invokeMethod(
+                machine,
+                "on_load_account_reg_state",
+                Qt::QueuedConnection,
+                Q_ARG(int, index),
+                Q_ARG(int, code),
+                Q_ARG(QString, text));
+        } else {
             QMetaObject::invokeMethod(
-                m_machine,
+                machine,
                 "on_account_reg_state",
                 Qt::QueuedConnection,
                 Q_ARG(int, code),
-                Q_ARG(QString, QString::fromStdString(text)));
+                Q_ARG(QString, text));
         }
     }
 
+    bool is_registered() const {
+        return m_registered.load(std::memory_order_acquire);
+    }
+
 private:
     SipMachine* m_machine;
+    int m_load_index;
+    std::atomic<bool> m_registered {false};
 };
 
-SipMachine::SipMachine(QObject* parent) : QObject(parent) {}
+SipMachine::SipMachine(QObject* parent) : QObject(parent) {
+    qRegisterMetaType<SipCallMedia>("SipCallMedia");
+}
 
 SipMachine::~SipMachine() {
     try {
         SipMachine::dereg_account();
+        SipMachine::remove_load_accounts();
+        //Queued events are handled before PJSIP is destroyed
+        m_dispatcher.reset();
+        m_media_player.reset();
+        m_tone_generator.reset();
 
         pjsip_endpt_unregister_module(pjsua_get_pjsip_endpt(), &mod_tx_hook);
         if (m_endpoint_inited) {
             m_endpoint.libDestroy();
             m_endpoint_inited = false;
         }
+        profile_plan.store(nullptr, std::memory_order_release);
+        m_header_plans.clear();
     } catch (pj::Error& err) {
         qWarning() << "PJSIP cleanup error:" << err.info().c_str();
     }
@@ -169,15 +206,25 @@ bool SipMachine::init() {
     try {
         m_endpoint.libCreate();
         pj::EpConfig endpoint_config;
-        endpoint_config.logConfig.level = 5;
+        //The writer gets everything up to level 6, the real limit is the runtime level (pj_log_set_level)
+        endpoint_config.logConfig.level = m_log_level;
+        endpoint_config.logConfig.consoleLevel = 6;
         endpoint_config.logConfig.msgLogging = 1;
+        endpoint_config.uaConfig.threadCnt = unsigned(m_worker_threads);
+        endpoint_config.uaConfig.mainThreadOnly = false;
         endpoint_config.uaConfig.natTypeInSdp = 0;
+        //The call-load needs more than the default 4 parallel calls, PJSUA_MAX_CALLS is the compile-time limit
+        endpoint_config.uaConfig.maxCalls = PJSUA_MAX_CALLS;
         endpoint_config.uaConfig.userAgent = (QCoreApplication::applicationName() + " " + QCoreApplication::applicationVersion()).toStdString();
 
         m_logwriter = new SipLogWriter(this);
         endpoint_config.logConfig.writer = m_logwriter;
 
-        connect(m_logwriter, &SipLogWriter::new_sip_message, this, &SipMachine::new_sip_message, Qt::QueuedConnection);
+        //The log-ring is drained in batches from the GUI-thread instead of one queued signal per message
+        m_log_timer = new QTimer(this);
+        m_log_timer->setInterval(50);
+        connect(m_log_timer, &QTimer::timeout, this, &SipMachine::drain_sip_log);
+        m_log_timer->start();
 
 
         m_endpoint.libInit(endpoint_config);
@@ -188,14 +235,43 @@ bool SipMachine::init() {
             qDebug() << "TX module registered OK";
         }
 
-        pj::TransportConfig transport_cfg;
-        transport_cfg.port = 5060;
-        m_endpoint.transportCreate(PJSIP_TRANSPORT_TCP, transport_cfg);
+        //A bounded pool of transports: with TCP/TLS PJSIP keeps one persistent connection per
+        //transport and proxy, so thousands of accounts share a few connections and local ports
+        pjsip_transport_type_e transport_type = PJSIP_TRANSPORT_TCP;
+        if (m_transport.type == SipTransportConfig::Udp) {
+            transport_type = PJSIP_TRANSPORT_UDP;
+        } else if (m_transport.type == SipTransportConfig::Tls) {
+            transport_type = PJSIP_TRANSPORT_TLS;
+        }
+        m_transport_ids.clear();
+        for (int i = 0; i < qMax(1, m_transport.connections); ++i) {
+            pj::TransportConfig transport_cfg;
+            transport_cfg.port = m_transport.local_port == 0 ? 0 : unsigned(m_transport.local_port + i);
+            if (m_transport.type == SipTransportConfig::Tls) {
+                transport_cfg.tlsConfig.CaListFile = m_transport.tls_ca_file.toStdString();
+                transport_cfg.tlsConfig.certFile = m_transport.tls_cert_file.toStdString();
+                transport_cfg.tlsConfig.privKeyFile = m_transport.tls_key_file.toStdString();
+                transport_cfg.tlsConfig.verifyServer = m_transport.tls_verify_server;
+            }
+            m_transport_ids.push_back(m_endpoint.transportCreate(transport_type, transport_cfg));
+        }
 
 
 
         m_endpoint.libStart();
         m_endpoint_inited = true;
+        SipMachine::init_media();
+
+        if (m_handler_threads > 0) {
+            m_dispatcher.reset(new SipDispatcher(m_handler_threads, [this](int index) {
+                try {
+                    m_endpoint.libRegisterThread(QString("SipHandler%1").arg(index).toStdString());
+                } catch (pj::Error& err) {
+                    qWarning() << "Handler-thread registration failed:" << err.info().c_str();
+                }
+            }));
+        }
+        qDebug() << "PJSIP started with" << m_worker_threads << "workers and" << m_handler_threads << "handler-threads";
         return true;
     } catch (pj::Error& err) {
         qWarning() << "PJSIP init error:" << err.info().c_str();
@@ -207,42 +283,109 @@ bool SipMachine::init() {
     }
 }
 
+void SipMachine::init_media() {
+    if (m_media.mode == SipMediaConfig::SoundDevice) {
+        return;
+    }
+
+    //The null-device only clocks the bridge, no sound-device thread and no hardware.
+    //The clock is needed even for Null: it drives the streams of the unconnected
+    //call-ports, which then send silence - media-inactivity timers see RTP.
+    pj::AudDevManager& manager = m_endpoint.audDevManager();
+    manager.setNullDev();
+    if (m_media.mode == SipMediaConfig::Null) {
+        qDebug() << "Media with the null-device, calls send silence";
+        return;
+    }
+
+    try {
+        if (m_media.mode == SipMediaConfig::File) {
+            m_media_player.reset(new pj::AudioMediaPlayer());
+            m_media_player->createPlayer(m_media.file.toStdString());
+        } else {
+            pj::ToneDesc tone;
+            tone.freq1 = short(m_media.tone_hz);
+            tone.freq2 = 0;
+            tone.on_msec = 1000;
+            tone.off_msec = 0;
+            m_tone_generator.reset(new pj::ToneGenerator());
+            m_tone_generator->createToneGenerator();
+            m_tone_generator->play(pj::ToneDescVector{tone}, true);
+        }
+    } catch (pj::Error& err) {
+        qWarning() << "Media source could not be created, calls stay silent:" << err.info().c_str();
+        m_media_player.reset();
+        m_tone_generator.reset();
+    }
+}
+
+void SipMachine::set_media(const SipMediaConfig& media) {
+    m_media = media;
+}
+
+const SipMediaConfig& SipMachine::media() const {
+    return m_media;
+}
+
+void SipMachine::apply_media(SipCall* call, bool load_call) const {
+    call->m_media_mode = m_media.mode;
+    if (load_call && m_media.mode == SipMediaConfig::SoundDevice) {
+        call->m_media_mode = SipMediaConfig::Null;
+    }
+    if (m_media_player) {
+        call->m_media_source = m_media_player.get();
+    } else if (m_tone_generator) {
+        call->m_media_source = m_tone_generator.get();
+    }
+}
+
+pj::AccountConfig SipMachine::account_config(const QString& username, const QString& proxy_ip, const QString& password, int account_index) const {
+    pj::AccountConfig acc_config;
+    std::string user = username.toStdString();
+    std::string proxy = proxy_ip.toStdString();
+    std::string target = "sip:" + proxy + ":" + std::to_string(m_transport.remote_port())
+                       + ";transport=" + m_transport.uri_parameter();
+
+    acc_config.idUri = "sip:" + user + "@tel.t-online.de";
+    acc_config.regConfig.registrarUri = target;
+    acc_config.regConfig.registerOnAdd = true;
+    acc_config.regConfig.timeoutSec = 550;
+
+    acc_config.sipConfig.proxies.clear();
+    acc_config.sipConfig.proxies.push_back(target);
+    if (!m_transport_ids.empty()) {
+        acc_config.sipConfig.transportId = m_transport_ids[size_t(account_index) % m_transport_ids.size()];
+    }
+    pj::AuthCredInfo credentials("digest", "*", user, 0, password.toStdString());
+    acc_config.sipConfig.authCreds.push_back(credentials);
+
+    pj::AccountCallConfig acc_call_config;
+    if (m_setup.req_rel) {
+        acc_call_config.prackUse = PJSUA_100REL_MANDATORY;
+    }
+    if (m_setup.req_timer) {
+        acc_call_config.timerUse = PJSUA_SIP_TIMER_REQUIRED;
+    }
+
+    acc_config.natConfig.sipOutboundUse = 0;
+    acc_config.natConfig.contactRewriteUse = 0;
+    acc_config.natConfig.contactRewriteMethod = 0;
+    acc_config.natConfig.viaRewriteUse = 0;
+
+    acc_config.callConfig = acc_call_config;
+    return acc_config;
+}
+
 bool SipMachine::create_account(const QString& username, const QString& proxy_ip, const QString& password, const CallSetup& setup) {
     if (!m_endpoint_inited && !init()) {
         return false;
     }
 
     m_setup = setup;
+    SipMachine::publish_tx_plan();
 
     try {
-        pj::AccountConfig acc_config;
-        std::string user = username.toStdString();
-        std::string proxy = proxy_ip.toStdString();
-
-        acc_config.idUri = "sip:" + user + "@tel.t-online.de";
-        acc_config.regConfig.registrarUri = "sip:" + proxy + ":5060;transport=tcp";
-        acc_config.regConfig.registerOnAdd = true;
-        acc_config.regConfig.timeoutSec = 550;
-
-        acc_config.sipConfig.proxies.clear();
-        acc_config.sipConfig.proxies.push_back("sip:" + proxy + ":5060;transport=tcp");
-        pj::AuthCredInfo credentials("digest", "*", user, 0, password.toStdString());
-        acc_config.sipConfig.authCreds.push_back(credentials);
-
-        pj::AccountCallConfig acc_call_config;
-        if (m_setup.req_rel) {
-            acc_call_config.prackUse = PJSUA_100REL_MANDATORY;
-        }
-        if (m_setup.req_timer) {
-            acc_call_config.timerUse = PJSUA_SIP_TIMER_REQUIRED;
-        }
-
-        acc_config.natConfig.sipOutboundUse = 0;
-        acc_config.natConfig.contactRewriteUse = 0;
-        acc_config.natConfig.contactRewriteMethod = 0;
-        acc_config.natConfig.viaRewriteUse = 0;
-
-        acc_config.callConfig = acc_call_config;
+        pj::AccountConfig acc_config = SipMachine::account_config(username, proxy_ip, password, 0);
         if (m_account) {
             m_account->setRegistration(false);
             delete m_account;
@@ -258,6 +401,130 @@ bool SipMachine::create_account(const QString& username, const QString& proxy_ip
     }
 }
 
+int SipMachine::create_load_accounts(const QString& csv_path, const QString& proxy_ip, const CallSetup& setup) {
+    if (!m_endpoint_inited && !init()) {
+        return 0;
+    }
+
+    QFile file(csv_path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Cannot open account-file" << csv_path;
+        return 0;
+    }
+
+    SipMachine::remove_load_accounts();
+    m_setup = setup;
+    SipMachine::publish_tx_plan();
+
+    //One account per line: user;password (a comma is accepted too), empty lines and # are skipped
+    while (!file.atEnd()) {
+        QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        QStringList fields = line.split(line.contains(';') ? ';' : ',');
+        if (fields.size() < 2) {
+            qWarning() << "Invalid account-line:" << line;
+            continue;
+        }
+
+        int index = int(m_load_accounts.size());
+        MyAccount* account = new MyAccount(this, index);
+        try {
+            account->create(SipMachine::account_config(fields[0].trimmed(), proxy_ip, fields[1].trimmed(), index));
+        } catch (pj::Error& err) {
+            qWarning() << "Load-account creation error:" << err.info().c_str();
+            delete account;
+            continue;
+        }
+        m_load_accounts.push_back(account);
+    }
+
+    qDebug() << "Load-accounts created:" << m_load_accounts.size();
+    return int(m_load_accounts.size());
+}
+
+void SipMachine::remove_load_accounts() {
+    for (MyAccount* account : m_load_accounts) {
+        try {
+            account->shutdown();
+        } catch (pj::Error& err) {
+            qWarning() << "Load-account shutdown failed:" << err.info().c_str();
+        }
+        delete account;
+    }
+    m_load_accounts.clear();
+}
+
+int SipMachine::load_account_count() const {
+    return int(m_load_accounts.size());
+}
+
+bool SipMachine::load_account_registered(int index) const {
+    return index >= 0 && index < int(m_load_accounts.size()) && m_load_accounts[size_t(index)]->is_registered();
+}
+
+pj::Account* SipMachine::load_account(int index) const {
+    if (index < 0 || index >= int(m_load_accounts.size())) {
+        return nullptr;
+    }
+    return m_load_accounts[size_t(index)];
+}
+
+void SipMachine::set_transport(const SipTransportConfig& transport) {
+    if (m_endpoint_inited) {
+        qWarning() << "SIP transport can only be set before the init";
+        return;
+    }
+    m_transport = transport;
+}
+
+void SipMachine::set_threading(int worker_threads, int handler_threads) {
+    if (m_endpoint_inited) {
+        qWarning() << "SIP threading can only be set before the init";
+        return;
+    }
+    m_worker_threads = qMax(1, worker_threads);
+    m_handler_threads = qMax(0, handler_threads);
+}
+
+SipDispatcher* SipMachine::dispatcher() const {
+    return m_dispatcher.get();
+}
+
+void SipMachine::set_log_level(int level) {
+    //PJSIP logs the SIP-messages with level 4, below that the FlowChart stays empty
+    m_log_level = qBound(0, level, 6);
+    if (m_endpoint_inited) {
+        pj_log_set_level(m_log_level);
+    }
+}
+
+int SipMachine::log_level() const {
+    return m_log_level;
+}
+
+void SipMachine::set_header_rules(const SipHeaderRules& rules) {
+    m_header_rules = rules;
+    SipMachine::publish_tx_plan();
+    qDebug() << "Header-rules active:" << rules.rules.size();
+}
+
+void SipMachine::publish_tx_plan() {
+    //The Supported-flags go first, so a header-rule can still override them. Compiled once, the
+    //TX-hook only follows the pointer. Replaced plans are kept until the library is destroyed
+    //because messages in flight may still hold clones of their headers.
+    SipHeaderRules rules = SipTxPlan::supported_rules(m_setup.supp_rel, m_setup.supp_timer);
+    rules.rules += m_header_rules.rules;
+    std::shared_ptr<const SipTxPlan> plan = SipTxPlan::compile(rules);
+    m_header_plans.push_back(plan);
+    profile_plan.store(plan->is_empty() ? nullptr : plan.get(), std::memory_order_release);
+}
+
+const CallSetup& SipMachine::setup() const {
+    return m_setup;
+}
+
 void SipMachine::dereg_account() {
     try {
         if (m_account) {
@@ -279,6 +546,49 @@ void SipMachine::dereg_account() {
     }
 }
 
+pj::CallOpParam SipMachine::call_param() const {
+    pj::CallOpParam prm(false);
+    pj::SipHeader allow_header;
+    allow_header.hName = "Allow";
+    if (m_setup.disable_update) {
+        allow_header.hValue = "PRACK, INVITE, ACK, BYE, CANCEL, INFO, SUBSCRIBE, NOTIFY, REFER, MESSAGE, OPTIONS";
+    } else {
+        allow_header.hValue = "PRACK, INVITE, ACK, BYE, UPDATE, CANCEL, INFO, SUBSCRIBE, NOTIFY, REFER, MESSAGE, OPTIONS";
+    }
+    prm.txOption.headers.push_back(allow_header);
+    return prm;
+}
+
+void SipMachine::set_custom_rtp(bool enabled) {
+    //Without a shared socket the engine would send from another port than the SDP announced
+    if (enabled && !RtpSocketHandle::supported()) {
+        qWarning() << "Custom RTP on calls needs a shared RTP-socket, not supported on this platform";
+        enabled = false;
+    }
+    m_custom_rtp = enabled;
+}
+
+bool SipMachine::custom_rtp() const {
+    return m_custom_rtp;
+}
+
+void SipMachine::on_call_media(const SipCallMedia& media) {
+    SipCallMedia negotiated = media;
+    //Without telephone-event in the answer the configured custom payload-type is used
+    if (negotiated.event_payload_type < 0 && m_setup.cust_televent) {
+        bool ok = false;
+        int payload_type = m_setup.cust_tel_pt.toInt(&ok);
+        if (ok && payload_type >= 96 && payload_type <= 127) {
+            negotiated.event_payload_type = payload_type;
+        }
+    }
+    emit call_media_ready(negotiated);
+}
+
+void SipMachine::on_call_media_ended(int call_id) {
+    emit call_media_ended(call_id);
+}
+
 bool SipMachine::make_call(const QString& destination) {
     if (!m_account) {
         qWarning() << "No account available";
@@ -286,21 +596,7 @@ bool SipMachine::make_call(const QString& destination) {
     }
 
     try {
-        pj::CallOpParam prm(false);
-        if (m_setup.disable_update) {
-            pj::SipHeader allow_header;
-            allow_header.hName = "Allow";
-            allow_header.hValue = "PRACK, INVITE, ACK, BYE, CANCEL, INFO, SUBSCRIBE, NOTIFY, REFER, MESSAGE, OPTIONS";
-            prm.txOption.headers.push_back(allow_header);
-        } else {
-            pj::SipHeader allow_header;
-            allow_header.hName = "Allow";
-            allow_header.hValue = "PRACK, INVITE, ACK, BYE, UPDATE, CANCEL, INFO, SUBSCRIBE, NOTIFY, REFER, MESSAGE, OPTIONS";
-            prm.txOption.headers.push_back(allow_header);
-        }
-
-
-
+        pj::CallOpParam prm = SipMachine::call_param();
         std::string uri = "sip:" + destination.toStdString();
         if (m_call) {
             delete m_call;
@@ -308,8 +604,9 @@ bool SipMachine::make_call(const QString& destination) {
         }
 
         m_call = new SipCall(*m_account);
-        m_call->m_rel_not_supported = m_setup.supp_rel;
-        m_call->m_timer_not_supported = m_setup.supp_timer;
+        SipMachine::apply_media(m_call, false);
+        m_call->m_custom_rtp = m_custom_rtp;
+        m_call->m_media_observer = this;
 
         m_call->makeCall(uri, prm);
         return true;
@@ -339,6 +636,27 @@ void SipMachine::on_account_reg_state(int sip_code, const QString& text) {
     emit registration_state_changed(sip_code, text);
 }
 
-void SipMachine::on_new_sip_message(const QString& message) {
-    emit new_sip_message(message);
+void SipMachine::on_load_account_reg_state(int index, int sip_code, const QString& text) {
+    //The registered-flag is already set by the account, here it is only reported
+    if (sip_code / 100 != 2) {
+        qWarning() << "Load-account" << index << "registration:" << sip_code << text;
+    }
+    emit load_account_reg_state(index, sip_code);
+}
+
+void SipMachine::drain_sip_log() {
+    if (!m_logwriter) {
+        return;
+    }
+
+    m_logwriter->ring().drain([this](const SipMessageInfo& info, const QByteArray& message) {
+        emit new_sip_message(info, message);
+    });
+
+    quint64 dropped = m_logwriter->ring().dropped();
+    if (dropped != m_log_dropped) {
+        qWarning() << "SIP log-ring overflow, dropped messages:" << dropped - m_log_dropped;
+        m_log_dropped = dropped;
+        emit sip_log_dropped(dropped);
+    }
 }
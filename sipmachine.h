@@ -27,7 +27,12 @@
  *are currently not supported and also not planned to implement.
  *
  *The custom-logwrite SipLogWriter is also instantiated here and maintained in
- *the matching member-variable.
+ *the matching member-variable. Its log-ring is drained here on a timer and
+ *the SIP-messages are handed over in batches.
+ *The media-mode (SipMediaConfig) decides if PJSIP opens a sound-device at
+ *all: Null, File and Tone only use the null-device as clock of the bridge.
+ *With Null the call-ports stay unconnected, so PJSIP sends silence; File/Tone
+ *have one shared player-port which transmits into every call.
  *
  * License:
  * This program is free software; you can redistribute it and/or modify
@@ -50,6 +55,10 @@
 #include <QObject>
 #include <QString>
 #include <QMetaObject>
+#include <QTimer>
+
+#include <memory>
+#include <vector>
 
 #include <pjsua2.hpp>
 #include <pjsip.h>
@@ -58,6 +67,9 @@
 
 #include "siplogwriter.h"
 #include "sipcall.h"
+#include "sipheaderrules.h"
+#include "siptxplan.h"
+#include "sipdispatcher.h"
 
 struct CallSetup {
     bool gatekeeper = false;
@@ -76,6 +88,22 @@ struct CallSetup {
     QString refresher = "uac";
 };
 
+struct SipTransportConfig {
+    enum Type { Udp, Tcp, Tls };
+
+    Type type = Tcp;
+    quint16 local_port = 5060;      //first local port, the pool uses local_port .. local_port + connections - 1
+    int connections = 1;            //transports in the pool, the accounts are spread round-robin
+    quint16 proxy_port = 0;         //0 = 5060, for TLS 5061
+    QString tls_ca_file;
+    QString tls_cert_file;
+    QString tls_key_file;
+    bool tls_verify_server = false;
+
+    const char* uri_parameter() const;
+    quint16 remote_port() const;
+};
+
 class SipMachine : public QObject {
     Q_OBJECT
 
@@ -83,7 +111,20 @@ public:
     explicit SipMachine(QObject* parent = nullptr);
     ~SipMachine();
 
+    //Must be called before init(): PJSIP worker-threads (at least 1) and handler-threads for the events (0 = GUI-thread)
+    void set_threading(int worker_threads, int handler_threads);
+    //Must be called before init()
+    void set_transport(const SipTransportConfig& transport);
+    //Must be called before init(), the GUI keeps the sound-device
+    void set_media(const SipMediaConfig& media);
+    const SipMediaConfig& media() const;
+    //Hands the media-mode and the shared source to a new call, load-calls never use the sound-device
+    void apply_media(SipCall* call, bool load_call) const;
     bool init();
+    SipDispatcher* dispatcher() const;
+    //Runtime log-level of PJSIP, the log itself is written lock-free into the log-ring
+    void set_log_level(int level);
+    int log_level() const;
     bool create_account(
         const QString& username,
         const QString& proxy_ip,
@@ -91,29 +132,72 @@ public:
         const CallSetup& setup
     );
 
+    //Calls made afterwards are sent by the RtpEngine, PJSIP's stream only receives
+    void set_custom_rtp(bool enabled);
+    bool custom_rtp() const;
     bool make_call(const QString& destination);
     void hangup_call();
     void dereg_account();
 
+    //Call-load: the accounts are read out of a csv-file with one "user;password" per line
+    int create_load_accounts(const QString& csv_path, const QString& proxy_ip, const CallSetup& setup);
+    void remove_load_accounts();
+    int load_account_count() const;
+    bool load_account_registered(int index) const;
+    pj::Account* load_account(int index) const;
+    const CallSetup& setup() const;
+    //Declarative header-manipulation of all outgoing messages, applied after the Supported-flags
+    void set_header_rules(const SipHeaderRules& rules);
+    pj::CallOpParam call_param() const;
+
 signals:
     void registration_state_changed(int sip_code, const QString& text);
-    void new_sip_message(const QString& message);
+    void new_sip_message(const SipMessageInfo& info, const QByteArray& message);
+    void sip_log_dropped(quint64 dropped);
+
+    void load_account_reg_state(int index, int sip_code);
+
+    //Negotiated media of the call, emitted again after every re-negotiation
+    void call_media_ready(const SipCallMedia& media);
+    void call_media_ended(int call_id);
 
 public slots:
     void on_account_reg_state(int sip_code, const QString& sip_text);
+    void on_load_account_reg_state(int index, int sip_code, const QString& sip_text);
+    void on_call_media(const SipCallMedia& media);
+    void on_call_media_ended(int call_id);
 
 private slots:
-    void on_new_sip_message(const QString& message);
+    void drain_sip_log();
+
+private:
+    void init_media();
+    void publish_tx_plan();
+    pj::AccountConfig account_config(const QString& username, const QString& proxy_ip, const QString& password, int account_index) const;
 
-private:    
     pj::Endpoint m_endpoint;
     bool m_endpoint_inited = false;
     SipLogWriter* m_logwriter = nullptr;
+    QTimer* m_log_timer = nullptr;
+    quint64 m_log_dropped = 0;
+    int m_log_level = 5;
+    int m_worker_threads = 1;
+    int m_handler_threads = 0;
+    std::unique_ptr<SipDispatcher> m_dispatcher;
+    SipTransportConfig m_transport;
+    std::vector<int> m_transport_ids;
+    SipMediaConfig m_media;
+    std::unique_ptr<pj::AudioMediaPlayer> m_media_player;
+    std::unique_ptr<pj::ToneGenerator> m_tone_generator;
 
     class MyAccount;
     MyAccount* m_account = nullptr;
+    std::vector<MyAccount*> m_load_accounts;
+    SipHeaderRules m_header_rules;
+    std::vector<std::shared_ptr<const SipTxPlan>> m_header_plans;
 
     SipCall* m_call = nullptr;
+    bool m_custom_rtp = false;
     CallSetup m_setup;
 };
 
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file siptxplan.h/cpp:
+ *The SipTxPlan-Class is the compiled header-rewrite for the TX-callback
+ *of the SipMachine. The Supported-flags of the call-setup and the
+ *SipHeaderRules are compiled once per profile into a list of ops with resolved header-types,
+ *method-masks and header-templates. Per message the callback only walks
+ *the header-list a single time and inserts shallow clones of the templates.
+ *An added header which is already in the message is not added again, so a
+ *message sent a second time (e.g. with credentials) keeps one copy.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "siptxplan.h"
+#include "sipclassifier.h"
+
+#include <QDebug>
+
+std::atomic<int> SipTxPlan::s_trace_level(0);
+
+struct KnownHeader {
+    const char* name;
+    pjsip_hdr_e type;
+};
+
+//Headers PJSIP parses into an own type, all others are generic and matched by name
+static const KnownHeader known_headers[] = {
+    {"Accept", PJSIP_H_ACCEPT},
+    {"Allow", PJSIP_H_ALLOW},
+    {"Contact", PJSIP_H_CONTACT},
+    {"Expires", PJSIP_H_EXPIRES},
+    {"Max-Forwards", PJSIP_H_MAX_FORWARDS},
+    {"Min-Expires", PJSIP_H_MIN_EXPIRES},
+    {"Record-Route", PJSIP_H_RECORD_ROUTE},
+    {"Require", PJSIP_H_REQUIRE},
+    {"Retry-After", PJSIP_H_RETRY_AFTER},
+    {"Route", PJSIP_H_ROUTE},
+    {"Supported", PJSIP_H_SUPPORTED},
+    {"Unsupported", PJSIP_H_UNSUPPORTED},
+};
+
+static pjsip_hdr_e header_type(const QString& name) {
+    for (const KnownHeader& known : known_headers) {
+        if (name.compare(QLatin1String(known.name), Qt::CaseInsensitive) == 0) {
+            return known.type;
+        }
+    }
+    return PJSIP_H_OTHER;
+}
+
+std::shared_ptr<const SipTxPlan> SipTxPlan::compile(const SipHeaderRules& rules) {
+    std::shared_ptr<SipTxPlan> plan(new SipTxPlan());
+    plan->m_ops.reserve(size_t(rules.rules.size()));
+
+    for (const SipHeaderRule& rule : rules.rules) {
+        if (plan->m_ops.size() == size_t(max_ops)) {
+            qWarning() << "Header-rules limited to" << max_ops << "rules, the rest is ignored";
+            break;
+        }
+
+        Op op;
+        op.action = rule.action;
+        op.requests = rule.requests;
+        op.responses = rule.responses;
+        op.type = header_type(rule.header);
+        op.name = rule.header.toLatin1();
+        op.value = rule.value.toUtf8();
+        op.method_mask = rule.methods.isEmpty() ? 0xFFFFFFFFu : 0;
+        for (const QString& method : rule.methods) {
+            QByteArray name = method.toLatin1();
+            SipMessageInfo::Method id = SipClassifier::parse_method(name.constData(), size_t(name.size()));
+            if (id == SipMessageInfo::UnknownMethod) {
+                qWarning() << "Header-rule: unknown method" << method << "matches all unknown methods";
+            }
+            op.method_mask |= 1u << id;
+        }
+        if (op.method_mask != 0xFFFFFFFFu) {
+            plan->m_needs_method = true;
+        }
+        plan->m_ops.push_back(op);
+    }
+
+    //The ops don't move anymore, the templates can point into their own byte-arrays
+    for (Op& op : plan->m_ops) {
+        op.name_str.ptr = op.name.data();
+        op.name_str.slen = op.name.size();
+        pj_str_t value;
+        value.ptr = op.value.data();
+        value.slen = op.value.size();
+        pjsip_generic_string_hdr_init2(&op.header, &op.name_str, &value);
+    }
+    return plan;
+}
+
+SipHeaderRules SipTxPlan::supported_rules(bool supp_rel, bool supp_timer) {
+    //PJSIP always offers both options, only the unchecked ones have to be taken out
+    SipHeaderRules rules;
+    if (supp_rel && supp_timer) {
+        return rules;
+    }
+
+    SipHeaderRule rule;
+    rule.header = "Supported";
+    rule.methods << "INVITE" << "UPDATE";
+    if (supp_rel || supp_timer) {
+        rule.action = SipHeaderRule::Replace;
+        rule.value = supp_rel ? "100rel" : "timer";
+    } else {
+        rule.action = SipHeaderRule::Remove;
+    }
+    rules.rules.push_back(rule);
+    return rules;
+}
+
+void SipTxPlan::apply(pjsip_tx_data* tdata) const {
+    if (m_ops.empty()) {
+        return;
+    }
+
+    pjsip_msg* msg = tdata->msg;
+    bool request = msg->type == PJSIP_REQUEST_MSG;
+    quint32 method_bit = 0xFFFFFFFFu;
+    if (m_needs_method) {
+        const pjsip_method* method = nullptr;
+        if (request) {
+            method = &msg->line.req.method;
+        } else {
+            const pjsip_cseq_hdr* cseq = static_cast<const pjsip_cseq_hdr*>(pjsip_msg_find_hdr(msg, PJSIP_H_CSEQ, nullptr));
+            method = cseq ? &cseq->method : nullptr;
+        }
+        SipMessageInfo::Method id = method
+            ? SipClassifier::parse_method(method->name.ptr, size_t(method->name.slen))
+            : SipMessageInfo::UnknownMethod;
+        method_bit = 1u << id;
+    }
+
+    //Selection of the ops for this message, at most max_ops
+    const Op* removes[max_ops];
+    const Op* adds[max_ops];
+    int remove_count = 0;
+    int add_count = 0;
+    for (const Op& op : m_ops) {
+        if (!(op.method_mask & method_bit) || !(request ? op.requests : op.responses)) {
+            continue;
+        }
+        if (op.action != SipHeaderRule::Add) {
+            removes[remove_count++] = &op;
+        }
+        if (op.action != SipHeaderRule::Remove) {
+            adds[add_count++] = &op;
+        }
+    }
+
+    //One pass over the header-list: the removing ops erase their headers, an add is skipped if the
+    //same header is already there (a message sent again after invalidate, e.g. with credentials)
+    bool present[max_ops] = {};
+    if (remove_count > 0 || add_count > 0) {
+        pjsip_hdr* end = &msg->hdr;
+        pjsip_hdr* hdr = end->next;
+        while (hdr != end) {
+            pjsip_hdr* next = hdr->next;
+            bool removed = false;
+            for (int i = 0; i < remove_count && !removed; ++i) {
+                const Op* op = removes[i];
+                if ((op->type != PJSIP_H_OTHER && hdr->type == op->type)
+                    || (hdr->name.slen == op->name_str.slen && pj_stricmp(&hdr->name, &op->name_str) == 0)) {
+                    pj_list_erase(hdr);
+                    removed = true;
+                }
+            }
+            for (int i = 0; i < add_count && !removed; ++i) {
+                if (!present[i] && SipTxPlan::is_same_header(hdr, adds[i]->header)) {
+                    present[i] = true;
+                }
+            }
+            hdr = next;
+        }
+    }
+
+    int added = 0;
+    for (int i = 0; i < add_count; ++i) {
+        if (present[i]) {
+            continue;
+        }
+        pjsip_hdr* header = static_cast<pjsip_hdr*>(pjsip_hdr_shallow_clone(tdata->pool, &adds[i]->header));
+        pjsip_msg_add_hdr(msg, header);
+        added++;
+    }
+
+    if (trace_enabled(1) && (remove_count > 0 || added > 0)) {
+        qDebug() << "TX header-rules applied:" << remove_count << "removing," << added << "adding";
+    }
+}
+
+bool SipTxPlan::is_same_header(const pjsip_hdr* hdr, const pjsip_generic_string_hdr& header) {
+    //Our clones and every header PJSIP does not parse are generic string-headers
+    if (hdr->type != PJSIP_H_OTHER || hdr->name.slen != header.name.slen || pj_stricmp(&hdr->name, &header.name) != 0) {
+        return false;
+    }
+    return pj_strcmp(&reinterpret_cast<const pjsip_generic_string_hdr*>(hdr)->hvalue, &header.hvalue) == 0;
+}
+
+bool SipTxPlan::is_empty() const {
+    return m_ops.empty();
+}
+
+void SipTxPlan::set_trace_level(int level) {
+    s_trace_level.store(level, std::memory_order_relaxed);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file siptxplan.h/cpp:
+ *The SipTxPlan-Class is the compiled header-rewrite for the TX-callback
+ *of the SipMachine. The Supported-flags of the call-setup and the
+ *SipHeaderRules are compiled once per profile into a list of ops with resolved header-types,
+ *method-masks and header-templates. Per message the callback only walks
+ *the header-list a single time and inserts shallow clones of the templates.
+ *An added header which is already in the message is not added again, so a
+ *message sent a second time (e.g. with credentials) keeps one copy.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#ifndef SIPTXPLAN_H
+#define SIPTXPLAN_H
+
+#include <pjsip.h>
+
+#include <QByteArray>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "sipheaderrules.h"
+
+//Compile-time upper bound of the TX-trace, 0 removes the logging from the callback completely
+#ifndef SIP_TX_TRACE
+#define SIP_TX_TRACE 1
+#endif
+
+//The inserted headers are shallow clones, a plan has to outlive every message it was applied to.
+//The SipMachine therefore never frees a published plan before the library is destroyed.
+class SipTxPlan {
+
+public:
+    static const int max_ops = 64;
+
+    static std::shared_ptr<const SipTxPlan> compile(const SipHeaderRules& rules);
+    //Rules of the call-setup flags for INVITE/UPDATE, the SipMachine compiles them with its header-rules
+    static SipHeaderRules supported_rules(bool supp_rel, bool supp_timer);
+
+    void apply(pjsip_tx_data* tdata) const;
+    bool is_empty() const;
+
+    //Runtime trace-level, 0 = off, 1 = one line per rewritten message
+    static void set_trace_level(int level);
+    static bool trace_enabled(int level);
+
+    SipTxPlan(const SipTxPlan&) = delete;
+    SipTxPlan& operator=(const SipTxPlan&) = delete;
+
+private:
+    SipTxPlan() = default;
+
+    struct Op {
+        SipHeaderRule::Action action;
+        quint32 method_mask;        //bit per SipMessageInfo::Method
+        bool requests;
+        bool responses;
+        pjsip_hdr_e type;           //PJSIP_H_OTHER = matched by name
+        QByteArray name;
+        QByteArray value;
+        pj_str_t name_str;
+        pjsip_generic_string_hdr header;
+    };
+
+    static bool is_same_header(const pjsip_hdr* hdr, const pjsip_generic_string_hdr& header);
+
+    std::vector<Op> m_ops;
+    bool m_needs_method = false;
+
+    static std::atomic<int> s_trace_level;
+};
+
+inline bool SipTxPlan::trace_enabled(int level) {
+    return SIP_TX_TRACE >= level && s_trace_level.load(std::memory_order_relaxed) >= level;
+}
+
+#endif // SIPTXPLAN_H
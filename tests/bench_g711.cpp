@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file bench_g711.cpp:
+ *Benchmark of the G711-Class: the block converters (what the CPU selects)
+ *against the single-sample reference in a loop, on a 20 ms frame at 8 kHz.
+ *Every block-benchmark checks its result against the reference, too.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "g711.h"
+
+#include <QtTest>
+
+class BenchG711 : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void encode_alaw_reference();
+    void encode_alaw_block();
+    void encode_ulaw_reference();
+    void encode_ulaw_block();
+    void decode_alaw_reference();
+    void decode_alaw_block();
+    void decode_ulaw_reference();
+    void decode_ulaw_block();
+
+private:
+    static const int frame_samples = 160;
+
+    int16_t m_pcm[frame_samples];
+    uint8_t m_codes[frame_samples];
+    uint8_t m_encoded[frame_samples];
+    int16_t m_decoded[frame_samples];
+};
+
+void BenchG711::initTestCase() {
+    qDebug() << "G.711 block converters:" << G711::implementation();
+    //Noise over the full range, so every segment is hit
+    uint32_t state = 0x12345678;
+    for (int i = 0; i < frame_samples; ++i) {
+        state = state * 1664525u + 1013904223u;
+        m_pcm[i] = int16_t(state >> 16);
+        m_codes[i] = uint8_t(state >> 8);
+    }
+}
+
+void BenchG711::encode_alaw_reference() {
+    QBENCHMARK {
+        for (int i = 0; i < frame_samples; ++i) {
+            m_encoded[i] = G711::linear_to_alaw(m_pcm[i]);
+        }
+    }
+}
+
+void BenchG711::encode_alaw_block() {
+    QBENCHMARK {
+        G711::encode_alaw(m_pcm, frame_samples, m_encoded);
+    }
+    for (int i = 0; i < frame_samples; ++i) {
+        QCOMPARE(m_encoded[i], G711::linear_to_alaw(m_pcm[i]));
+    }
+}
+
+void BenchG711::encode_ulaw_reference() {
+    QBENCHMARK {
+        for (int i = 0; i < frame_samples; ++i) {
+            m_encoded[i] = G711::linear_to_ulaw(m_pcm[i]);
+        }
+    }
+}
+
+void BenchG711::encode_ulaw_block() {
+    QBENCHMARK {
+        G711::encode_ulaw(m_pcm, frame_samples, m_encoded);
+    }
+    for (int i = 0; i < frame_samples; ++i) {
+        QCOMPARE(m_encoded[i], G711::linear_to_ulaw(m_pcm[i]));
+    }
+}
+
+void BenchG711::decode_alaw_reference() {
+    QBENCHMARK {
+        for (int i = 0; i < frame_samples; ++i) {
+            m_decoded[i] = G711::alaw_to_linear(m_codes[i]);
+        }
+    }
+}
+
+void BenchG711::decode_alaw_block() {
+    QBENCHMARK {
+        G711::decode_alaw(m_codes, frame_samples, m_decoded);
+    }
+    for (int i = 0; i < frame_samples; ++i) {
+        QCOMPARE(m_decoded[i], G711::alaw_to_linear(m_codes[i]));
+    }
+}
+
+void BenchG711::decode_ulaw_reference() {
+    QBENCHMARK {
+        for (int i = 0; i < frame_samples; ++i) {
+            m_decoded[i] = G711::ulaw_to_linear(m_codes[i]);
+        }
+    }
+}
+
+void BenchG711::decode_ulaw_block() {
+    QBENCHMARK {
+        G711::decode_ulaw(m_codes, frame_samples, m_decoded);
+    }
+    for (int i = 0; i < frame_samples; ++i) {
+        QCOMPARE(m_decoded[i], G711::ulaw_to_linear(m_codes[i]));
+    }
+}
+
+QTEST_APPLESS_MAIN(BenchG711)
+
+#include "bench_g711.moc"
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file tst_g711.cpp:
+ *Unit test of the G711-Class: the block converters (SSE4.1/AVX2 or scalar,
+ *whatever the CPU selects) are compared with the single-sample reference for
+ *all 65536 linear values and all 256 codes, in addition with every offset
+ *and length around the vector widths.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "g711.h"
+
+#include <QtTest>
+
+#include <vector>
+
+class TestG711 : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void reference_values();
+    void encode_alaw_exhaustive();
+    void encode_ulaw_exhaustive();
+    void decode_alaw_exhaustive();
+    void decode_ulaw_exhaustive();
+    void round_trip();
+    void block_tails();
+
+private:
+    std::vector<int16_t> m_pcm;     //every linear value once
+    std::vector<uint8_t> m_codes;   //every code, repeated so the vector-loops get full blocks
+};
+
+void TestG711::initTestCase() {
+    qDebug() << "G.711 block converters:" << G711::implementation();
+    for (int value = -32768; value <= 32767; ++value) {
+        m_pcm.push_back(int16_t(value));
+    }
+    for (int i = 0; i < 256 * 4 + 7; ++i) {
+        m_codes.push_back(uint8_t(i));
+    }
+}
+
+void TestG711::reference_values() {
+    //ITU-T G.711 table 1/2: zero and the largest magnitudes
+    QCOMPARE(G711::linear_to_alaw(0), uint8_t(0xD5));
+    QCOMPARE(G711::linear_to_alaw(32767), uint8_t(0xAA));
+    QCOMPARE(G711::linear_to_alaw(-32768), uint8_t(0x2A));
+    QCOMPARE(G711::linear_to_ulaw(0), uint8_t(0xFF));
+    QCOMPARE(G711::linear_to_ulaw(32767), uint8_t(0x80));
+    QCOMPARE(G711::linear_to_ulaw(-32768), uint8_t(0x00));
+
+    QCOMPARE(G711::alaw_to_linear(0xD5), int16_t(8));
+    QCOMPARE(G711::alaw_to_linear(0x55), int16_t(-8));
+    QCOMPARE(G711::alaw_to_linear(0xAA), int16_t(32256));
+    QCOMPARE(G711::alaw_to_linear(0x2A), int16_t(-32256));
+    QCOMPARE(G711::ulaw_to_linear(0xFF), int16_t(0));
+    QCOMPARE(G711::ulaw_to_linear(0x80), int16_t(32124));
+    QCOMPARE(G711::ulaw_to_linear(0x00), int16_t(-32124));
+}
+
+void TestG711::encode_alaw_exhaustive() {
+    std::vector<uint8_t> out(m_pcm.size());
+    G711::encode_alaw(m_pcm.data(), m_pcm.size(), out.data());
+    for (size_t i = 0; i < m_pcm.size(); ++i) {
+        QCOMPARE(out[i], G711::linear_to_alaw(m_pcm[i]));
+    }
+}
+
+void TestG711::encode_ulaw_exhaustive() {
+    std::vector<uint8_t> out(m_pcm.size());
+    G711::encode_ulaw(m_pcm.data(), m_pcm.size(), out.data());
+    for (size_t i = 0; i < m_pcm.size(); ++i) {
+        QCOMPARE(out[i], G711::linear_to_ulaw(m_pcm[i]));
+    }
+}
+
+void TestG711::decode_alaw_exhaustive() {
+    std::vector<int16_t> out(m_codes.size());
+    G711::decode_alaw(m_codes.data(), m_codes.size(), out.data());
+    for (size_t i = 0; i < m_codes.size(); ++i) {
+        QCOMPARE(out[i], G711::alaw_to_linear(m_codes[i]));
+    }
+}
+
+void TestG711::decode_ulaw_exhaustive() {
+    std::vector<int16_t> out(m_codes.size());
+    G711::decode_ulaw(m_codes.data(), m_codes.size(), out.data());
+    for (size_t i = 0; i < m_codes.size(); ++i) {
+        QCOMPARE(out[i], G711::ulaw_to_linear(m_codes[i]));
+    }
+}
+
+void TestG711::round_trip() {
+    //Every code decodes to a value which encodes to the same code, only u-law has a negative zero
+    for (int code = 0; code < 256; ++code) {
+        QCOMPARE(G711::linear_to_alaw(G711::alaw_to_linear(uint8_t(code))), uint8_t(code));
+        if (code != 0x7F) {
+            QCOMPARE(G711::linear_to_ulaw(G711::ulaw_to_linear(uint8_t(code))), uint8_t(code));
+        }
+    }
+}
+
+void TestG711::block_tails() {
+    //Unaligned starts and every length up to 2.5 AVX2-blocks, nothing is written behind the block
+    const uint8_t guard = 0xA5;
+    for (size_t offset = 0; offset < 40; ++offset) {
+        const int16_t* pcm = m_pcm.data() + offset * 1601;
+        const uint8_t* codes = m_codes.data() + offset;
+        for (size_t samples = 0; samples <= 80; ++samples) {
+            std::vector<uint8_t> alaw(samples + 1, guard);
+            std::vector<uint8_t> ulaw(samples + 1, guard);
+            std::vector<int16_t> linear(samples + 1, int16_t(guard));
+            G711::encode_alaw(pcm, samples, alaw.data());
+            G711::encode_ulaw(pcm, samples, ulaw.data());
+            G711::decode_ulaw(codes, samples, linear.data());
+            for (size_t i = 0; i < samples; ++i) {
+                QCOMPARE(alaw[i], G711::linear_to_alaw(pcm[i]));
+                QCOMPARE(ulaw[i], G711::linear_to_ulaw(pcm[i]));
+                QCOMPARE(linear[i], G711::ulaw_to_linear(codes[i]));
+            }
+            QCOMPARE(alaw[samples], guard);
+            QCOMPARE(ulaw[samples], guard);
+            QCOMPARE(linear[samples], int16_t(guard));
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestG711)
+
+#include "tst_g711.moc"
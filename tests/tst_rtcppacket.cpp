@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file tst_rtcppacket.cpp:
+ *Unit test of the RtcpPacket-Class: layout of the written SR/RR/SDES/BYE,
+ *parsing of report blocks out of a compound paket (also broken ones) and
+ *the round-trip-time of RFC 3550 6.4.1.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "rtcppacket.h"
+
+#include <QtTest>
+
+#include <cstring>
+
+class TestRtcpPacket : public QObject {
+    Q_OBJECT
+
+private slots:
+    void ntp_timestamp();
+    void sender_report_layout();
+    void compound_layout();
+    void receiver_report_blocks();
+    void skip_blocks_beyond_max();
+    void reject_invalid();
+    void round_trip();
+
+private:
+    static uint32_t read_u32(const uint8_t* in);
+    static void write_u32(uint8_t* out, uint32_t value);
+    //RR of sender 1 with one block: 64/256 lost, cumulative -2, LSR 0x10000, DLSR 0.5 s
+    static int write_rr_block(uint8_t* out, uint32_t ssrc);
+};
+
+uint32_t TestRtcpPacket::read_u32(const uint8_t* in) {
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | in[3];
+}
+
+void TestRtcpPacket::write_u32(uint8_t* out, uint32_t value) {
+    out[0] = uint8_t(value >> 24);
+    out[1] = uint8_t(value >> 16);
+    out[2] = uint8_t(value >> 8);
+    out[3] = uint8_t(value);
+}
+
+int TestRtcpPacket::write_rr_block(uint8_t* out, uint32_t ssrc) {
+    memset(out, 0, 32);
+    out[0] = 0x81;
+    out[1] = RtcpPacket::type_rr;
+    out[3] = 7;
+    TestRtcpPacket::write_u32(out + 4, 1);
+    TestRtcpPacket::write_u32(out + 8, ssrc);
+    out[12] = 64;
+    out[13] = 0xFF;
+    out[14] = 0xFF;
+    out[15] = 0xFE;
+    TestRtcpPacket::write_u32(out + 16, 100);
+    TestRtcpPacket::write_u32(out + 20, 80);
+    TestRtcpPacket::write_u32(out + 24, 0x10000);
+    TestRtcpPacket::write_u32(out + 28, 0x8000);
+    return 32;
+}
+
+void TestRtcpPacket::ntp_timestamp() {
+    QCOMPARE(RtcpPacket::ntp_timestamp(0), quint64(2208988800ULL) << 32);
+    //Half a second is half of the 32 bit fraction
+    QCOMPARE(RtcpPacket::ntp_timestamp(1500000000LL), ((quint64(2208988801ULL) << 32) | 0x80000000ULL));
+    QCOMPARE(RtcpPacket::ntp_middle(0x0123456789ABCDEFULL), uint32_t(0x456789AB));
+}
+
+void TestRtcpPacket::sender_report_layout() {
+    uint8_t out[RtcpPacket::max_compound_size];
+    int size = RtcpPacket::write_sender_report(out, 0x11223344, 0x0102030405060708ULL, 5, 6, 7);
+    QCOMPARE(size, 28);
+    QCOMPARE(out[0], uint8_t(0x80));
+    QCOMPARE(out[1], uint8_t(RtcpPacket::type_sr));
+    QCOMPARE((out[2] << 8) | out[3], 6);
+    QCOMPARE(TestRtcpPacket::read_u32(out + 4), uint32_t(0x11223344));
+    QCOMPARE(TestRtcpPacket::read_u32(out + 8), uint32_t(0x01020304));
+    QCOMPARE(TestRtcpPacket::read_u32(out + 12), uint32_t(0x05060708));
+    QCOMPARE(TestRtcpPacket::read_u32(out + 16), uint32_t(5));
+    QCOMPARE(TestRtcpPacket::read_u32(out + 20), uint32_t(6));
+    QCOMPARE(TestRtcpPacket::read_u32(out + 24), uint32_t(7));
+}
+
+void TestRtcpPacket::compound_layout() {
+    uint8_t out[RtcpPacket::max_compound_size];
+    int size = RtcpPacket::write_sender_report(out, 0x11223344, RtcpPacket::ntp_timestamp(0), 0, 0, 0);
+    int sdes = RtcpPacket::write_sdes_cname(out + size, 0x11223344, QByteArray("abc"));
+    //SSRC + CNAME-item with 3 bytes + null-octet, padded to 16
+    QCOMPARE(sdes, 16);
+    QCOMPARE(out[size + 0], uint8_t(0x81));
+    QCOMPARE(out[size + 1], uint8_t(RtcpPacket::type_sdes));
+    QCOMPARE((out[size + 2] << 8) | out[size + 3], 3);
+    QCOMPARE(out[size + 8], uint8_t(1));
+    QCOMPARE(out[size + 9], uint8_t(3));
+    QCOMPARE(memcmp(out + size + 10, "abc", 3), 0);
+    QCOMPARE(out[size + 13], uint8_t(0));
+    size += sdes;
+    int bye = RtcpPacket::write_bye(out + size, 0x11223344);
+    QCOMPARE(bye, 8);
+    QCOMPARE(out[size + 1], uint8_t(RtcpPacket::type_bye));
+    size += bye;
+
+    //An own compound is valid RTCP without report blocks
+    RtcpReportBlock blocks[4];
+    QCOMPARE(RtcpPacket::parse_report_blocks(out, size, blocks, 4), 0);
+    QCOMPARE(RtcpPacket::write_receiver_report(out, 1), 8);
+    QCOMPARE(RtcpPacket::parse_report_blocks(out, 8, blocks, 4), 0);
+
+    //The CNAME is cut to 255 bytes, SR + the longest SDES + BYE fill max_compound_size
+    uint8_t full[RtcpPacket::max_compound_size];
+    size = RtcpPacket::write_sender_report(full, 1, 0, 0, 0, 0);
+    size += RtcpPacket::write_sdes_cname(full + size, 1, QByteArray(300, 'x'));
+    size += RtcpPacket::write_bye(full + size, 1);
+    QCOMPARE(size, int(RtcpPacket::max_compound_size));
+    QCOMPARE(full[28 + 9], uint8_t(255));
+}
+
+void TestRtcpPacket::receiver_report_blocks() {
+    uint8_t rr[32];
+    int size = TestRtcpPacket::write_rr_block(rr, 0xAABBCCDD);
+    RtcpReportBlock blocks[4];
+    QCOMPARE(RtcpPacket::parse_report_blocks(rr, size, blocks, 4), 1);
+    QCOMPARE(blocks[0].ssrc, uint32_t(0xAABBCCDD));
+    QCOMPARE(blocks[0].fraction_lost, uint8_t(64));
+    QCOMPARE(blocks[0].cumulative_lost, int32_t(-2));
+    QCOMPARE(blocks[0].highest_sequence, uint32_t(100));
+    QCOMPARE(blocks[0].jitter, uint32_t(80));
+    QCOMPARE(blocks[0].last_sr, uint32_t(0x10000));
+    QCOMPARE(blocks[0].delay_since_last_sr, uint32_t(0x8000));
+
+    //Blocks of every SR/RR of a compound are returned
+    uint8_t compound[64];
+    TestRtcpPacket::write_rr_block(compound, 1);
+    TestRtcpPacket::write_rr_block(compound + 32, 2);
+    QCOMPARE(RtcpPacket::parse_report_blocks(compound, 64, blocks, 4), 2);
+    QCOMPARE(blocks[1].ssrc, uint32_t(2));
+}
+
+void TestRtcpPacket::skip_blocks_beyond_max() {
+    uint8_t compound[64];
+    TestRtcpPacket::write_rr_block(compound, 1);
+    TestRtcpPacket::write_rr_block(compound + 32, 2);
+    RtcpReportBlock blocks[1];
+    QCOMPARE(RtcpPacket::parse_report_blocks(compound, 64, blocks, 1), 1);
+    QCOMPARE(blocks[0].ssrc, uint32_t(1));
+}
+
+void TestRtcpPacket::reject_invalid() {
+    uint8_t rr[32];
+    RtcpReportBlock blocks[4];
+    TestRtcpPacket::write_rr_block(rr, 1);
+    //Length field beyond the datagram
+    QCOMPARE(RtcpPacket::parse_report_blocks(rr, 20, blocks, 4), -1);
+    QCOMPARE(RtcpPacket::parse_report_blocks(rr, 4, blocks, 4), -1);
+    //Version 1
+    rr[0] = 0x41;
+    QCOMPARE(RtcpPacket::parse_report_blocks(rr, 32, blocks, 4), -1);
+    //Compound starting with SDES
+    TestRtcpPacket::write_rr_block(rr, 1);
+    rr[1] = RtcpPacket::type_sdes;
+    QCOMPARE(RtcpPacket::parse_report_blocks(rr, 32, blocks, 4), -1);
+}
+
+void TestRtcpPacket::round_trip() {
+    uint8_t rr[32];
+    RtcpReportBlock blocks[1];
+    TestRtcpPacket::write_rr_block(rr, 1);
+    QCOMPARE(RtcpPacket::parse_report_blocks(rr, 32, blocks, 1), 1);
+    //A - LSR - DLSR = 0x0CCD / 65536 s
+    double rtt = RtcpPacket::round_trip_ms(0x10000 + 0x8000 + 0x0CCD, blocks[0]);
+    QVERIFY(qAbs(rtt - 50.0) < 0.01);
+    //Reports before our first SR and arrivals before LSR + DLSR are no round-trip
+    QCOMPARE(RtcpPacket::round_trip_ms(0x20000, RtcpReportBlock()), -1.0);
+    QCOMPARE(RtcpPacket::round_trip_ms(0x10000, blocks[0]), -1.0);
+}
+
+QTEST_APPLESS_MAIN(TestRtcpPacket)
+
+#include "tst_rtcppacket.moc"
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file tst_rtpdtmf.cpp:
+ *Unit test of the RtpDtmfSequence-Class: the RFC 4733 pakets compiled per
+ *ptime (ticks, marker, end-bit, duration and the three end-pakets), the
+ *validation of a sequence and the plan for several ptimes.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "rtpdtmf.h"
+
+#include <QtTest>
+
+class TestRtpDtmf : public QObject {
+    Q_OBJECT
+
+private slots:
+    void event_codes();
+    void compile_20ms();
+    void compile_30ms();
+    void partial_last_slot();
+    void pause_covers_end_pakets();
+    void validation();
+    void plan();
+
+private:
+    static int duration(const RtpDtmfPaket& paket);
+    static bool is_end(const RtpDtmfPaket& paket);
+};
+
+int TestRtpDtmf::duration(const RtpDtmfPaket& paket) {
+    return (paket.payload[2] << 8) | paket.payload[3];
+}
+
+bool TestRtpDtmf::is_end(const RtpDtmfPaket& paket) {
+    return (paket.payload[1] & 0x80) != 0;
+}
+
+void TestRtpDtmf::event_codes() {
+    uint8_t code = 0;
+    QVERIFY(RtpDtmfSequence::event_code(QChar('0'), code));
+    QCOMPARE(code, uint8_t(0));
+    QVERIFY(RtpDtmfSequence::event_code(QChar('9'), code));
+    QCOMPARE(code, uint8_t(9));
+    QVERIFY(RtpDtmfSequence::event_code(QChar('*'), code));
+    QCOMPARE(code, uint8_t(10));
+    QVERIFY(RtpDtmfSequence::event_code(QChar('#'), code));
+    QCOMPARE(code, uint8_t(11));
+    QVERIFY(RtpDtmfSequence::event_code(QChar('a'), code));
+    QCOMPARE(code, uint8_t(12));
+    QVERIFY(RtpDtmfSequence::event_code(QChar('D'), code));
+    QCOMPARE(code, uint8_t(15));
+    QVERIFY(!RtpDtmfSequence::event_code(QChar('E'), code));
+    QVERIFY(!RtpDtmfSequence::event_code(QChar(' '), code));
+}
+
+void TestRtpDtmf::compile_20ms() {
+    RtpDtmfSequence sequence;
+    sequence.digits = "1#";
+    sequence.duration_ms = 100;
+    sequence.pause_ms = 60;
+    sequence.volume = 10;
+    std::vector<RtpDtmfPaket> pakets = sequence.compile(20);
+
+    //Per digit 5 event-pakets, the last one sent three times
+    QCOMPARE(pakets.size(), size_t(2 * (5 + RtpDtmfSequence::end_pakets - 1)));
+    for (size_t i = 0; i < 7; ++i) {
+        const RtpDtmfPaket& paket = pakets[i];
+        QCOMPARE(paket.tick, uint64_t(i));
+        QCOMPARE(paket.marker, i == 0);
+        QCOMPARE(paket.payload[0], uint8_t(1));
+        QCOMPARE(paket.payload[1] & 0x3F, 10);
+        QCOMPARE(TestRtpDtmf::is_end(paket), i >= 4);
+        QCOMPARE(TestRtpDtmf::duration(paket), i >= 4 ? 800 : int(i + 1) * 160);
+    }
+
+    //The next event starts after 100 ms event and 60 ms pause
+    QCOMPARE(pakets[7].tick, uint64_t(8));
+    QVERIFY(pakets[7].marker);
+    QCOMPARE(pakets[7].payload[0], uint8_t(11));
+    QCOMPARE(pakets.back().tick, uint64_t(14));
+}
+
+void TestRtpDtmf::compile_30ms() {
+    RtpDtmfSequence sequence;
+    sequence.digits = "5";
+    sequence.duration_ms = 90;
+    std::vector<RtpDtmfPaket> pakets = sequence.compile(30);
+    QCOMPARE(pakets.size(), size_t(3 + RtpDtmfSequence::end_pakets - 1));
+    QCOMPARE(TestRtpDtmf::duration(pakets[0]), 240);
+    QCOMPARE(TestRtpDtmf::duration(pakets[1]), 480);
+    QVERIFY(!TestRtpDtmf::is_end(pakets[1]));
+    for (size_t i = 2; i < pakets.size(); ++i) {
+        QVERIFY(TestRtpDtmf::is_end(pakets[i]));
+        QCOMPARE(TestRtpDtmf::duration(pakets[i]), 720);
+    }
+}
+
+void TestRtpDtmf::partial_last_slot() {
+    //50 ms on 20 ms: the third paket ends the event with the exact duration
+    RtpDtmfSequence sequence;
+    sequence.digits = "7";
+    sequence.duration_ms = 50;
+    std::vector<RtpDtmfPaket> pakets = sequence.compile(20);
+    QCOMPARE(pakets.size(), size_t(3 + RtpDtmfSequence::end_pakets - 1));
+    QCOMPARE(TestRtpDtmf::duration(pakets[1]), 320);
+    QVERIFY(TestRtpDtmf::is_end(pakets[2]));
+    QCOMPARE(TestRtpDtmf::duration(pakets[2]), 400);
+}
+
+void TestRtpDtmf::pause_covers_end_pakets() {
+    //Without pause the next event still waits for the retransmitted end-pakets
+    RtpDtmfSequence sequence;
+    sequence.digits = "12";
+    sequence.duration_ms = 40;
+    sequence.pause_ms = 0;
+    std::vector<RtpDtmfPaket> pakets = sequence.compile(20);
+    QCOMPARE(pakets.size(), size_t(2 * (2 + RtpDtmfSequence::end_pakets - 1)));
+    QCOMPARE(pakets[3].tick, uint64_t(3));
+    QCOMPARE(pakets[4].tick, uint64_t(4));
+    QVERIFY(pakets[4].marker);
+
+    QVERIFY(sequence.compile(0).empty());
+}
+
+void TestRtpDtmf::validation() {
+    RtpDtmfSequence sequence;
+    sequence.digits = "0123456789*#ABCD";
+    QVERIFY(sequence.is_valid());
+
+    RtpDtmfSequence invalid = sequence;
+    invalid.digits = "1x";
+    QVERIFY(!invalid.is_valid());
+    invalid.digits = "";
+    QVERIFY(!invalid.is_valid());
+
+    //The duration-field has 16 bit at 8 kHz
+    invalid = sequence;
+    invalid.duration_ms = 8191;
+    QVERIFY(invalid.is_valid());
+    invalid.duration_ms = 8192;
+    QVERIFY(!invalid.is_valid());
+    invalid.duration_ms = 0;
+    QVERIFY(!invalid.is_valid());
+
+    invalid = sequence;
+    invalid.volume = 64;
+    QVERIFY(!invalid.is_valid());
+    invalid = sequence;
+    invalid.pause_ms = -1;
+    QVERIFY(!invalid.is_valid());
+}
+
+void TestRtpDtmf::plan() {
+    RtpDtmfSequence sequence;
+    sequence.digits = "1";
+    std::shared_ptr<const RtpDtmfPlan> plan = sequence.compile_plan({20, 30, 20});
+    QVERIFY(plan);
+    QVERIFY(plan->pakets(20));
+    QVERIFY(plan->pakets(30));
+    QVERIFY(!plan->pakets(40));
+    QCOMPARE(plan->pakets(20)->size(), sequence.compile(20).size());
+    QCOMPARE(plan->pakets(30)->size(), sequence.compile(30).size());
+
+    sequence.digits = "x";
+    QVERIFY(!sequence.compile_plan({20}));
+}
+
+QTEST_APPLESS_MAIN(TestRtpDtmf)
+
+#include "tst_rtpdtmf.moc"
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file tst_rtpreceivestream.cpp:
+ *Unit test of the RtpReceiveStream-Class: sequence-tracking of RFC 3550 A.1
+ *(wrap, loss, reordered pakets, duplicates, restart of the sender) and the
+ *interarrival-jitter of A.8, fed with synthetic arrival-times.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "rtpreceivestream.h"
+
+#include <QtTest>
+
+class TestRtpReceiveStream : public QObject {
+    Q_OBJECT
+
+private slots:
+    void wrap_without_loss();
+    void loss_reorder_duplicate();
+    void sender_restart();
+    void jitter();
+    void report_tracking();
+    void clock_rate();
+
+private:
+    static const int64_t ptime_ns = 20000000;
+};
+
+void TestRtpReceiveStream::wrap_without_loss() {
+    RtpReceiveStream stream;
+    int64_t arrival = 0;
+    stream.init(1, 5004, 8, 65530, 0, arrival);
+    for (int i = 1; i < 20; ++i) {
+        arrival += ptime_ns;
+        stream.on_paket(uint16_t(65530 + i), uint32_t(i * 160), arrival);
+    }
+    RtpReceiveStats stats = stream.stats();
+    QCOMPARE(stats.ssrc, quint32(1));
+    QCOMPARE(stats.port, quint16(5004));
+    QCOMPARE(stats.payload_type, quint8(8));
+    QCOMPARE(stats.packets, quint64(20));
+    QCOMPARE(stats.lost, qint64(0));
+    QCOMPARE(stats.reordered, quint64(0));
+    QCOMPARE(stats.duplicates, quint64(0));
+    QVERIFY(stats.jitter_ms < 0.01);
+    QVERIFY(qAbs(stats.max_gap_ms - 20.0) < 0.01);
+}
+
+void TestRtpReceiveStream::loss_reorder_duplicate() {
+    RtpReceiveStream stream;
+    int64_t arrival = 0;
+    stream.init(1, 5004, 0, 100, 0, arrival);
+    //102 and 104 arrive late, 102 twice, 107-109 never
+    const uint16_t sequences[] = {101, 103, 102, 102, 105, 106, 104, 110};
+    for (uint16_t sequence : sequences) {
+        arrival += ptime_ns;
+        stream.on_paket(sequence, uint32_t(sequence - 100) * 160, arrival);
+    }
+    RtpReceiveStats stats = stream.stats();
+    QCOMPARE(stats.packets, quint64(8));
+    QCOMPARE(stats.lost, qint64(3));
+    QCOMPARE(stats.reordered, quint64(2));
+    QCOMPARE(stats.duplicates, quint64(1));
+    QVERIFY(qAbs(stats.loss_percent - 300.0 / 11.0) < 0.01);
+}
+
+void TestRtpReceiveStream::sender_restart() {
+    RtpReceiveStream stream;
+    int64_t arrival = 0;
+    stream.init(1, 5004, 0, 100, 0, arrival);
+    for (uint16_t sequence = 101; sequence <= 110; ++sequence) {
+        arrival += ptime_ns;
+        stream.on_paket(sequence, uint32_t(sequence - 100) * 160, arrival);
+    }
+
+    //A single paket far away is ignored
+    arrival += ptime_ns;
+    stream.on_paket(30000, 0, arrival);
+    arrival += ptime_ns;
+    stream.on_paket(111, 11 * 160, arrival);
+    QCOMPARE(stream.stats().packets, quint64(12));
+    QCOMPARE(stream.stats().lost, qint64(0));
+
+    //Two sequential pakets restart the statistic
+    arrival += ptime_ns;
+    stream.on_paket(40000, 0, arrival);
+    arrival += ptime_ns;
+    stream.on_paket(40001, 160, arrival);
+    arrival += ptime_ns;
+    stream.on_paket(40002, 320, arrival);
+    RtpReceiveStats stats = stream.stats();
+    QCOMPARE(stats.packets, quint64(2));
+    QCOMPARE(stats.lost, qint64(0));
+}
+
+void TestRtpReceiveStream::jitter() {
+    //Arrivals alternate 5 ms early/late: D is 10 ms, J converges to 10 ms
+    RtpReceiveStream stream;
+    int64_t arrival = 0;
+    stream.init(1, 5004, 0, 0, 0, arrival);
+    for (int i = 1; i < 200; ++i) {
+        arrival = i * ptime_ns + ((i % 2) ? 5000000 : -5000000);
+        stream.on_paket(uint16_t(i), uint32_t(i * 160), arrival);
+    }
+    RtpReceiveStats stats = stream.stats();
+    QVERIFY(stats.jitter_ms > 9.0 && stats.jitter_ms < 10.5);
+    QVERIFY(qAbs(stats.max_gap_ms - 30.0) < 0.01);
+}
+
+void TestRtpReceiveStream::report_tracking() {
+    RtpReceiveStream stream;
+    stream.init(1, 5004, 0, 0, 0, 0);
+    QVERIFY(stream.changed_since_report());
+    stream.mark_reported();
+    QVERIFY(!stream.changed_since_report());
+    //A duplicate is no change
+    stream.on_paket(0, 0, ptime_ns);
+    QVERIFY(!stream.changed_since_report());
+    stream.on_paket(1, 160, ptime_ns);
+    QVERIFY(stream.changed_since_report());
+}
+
+void TestRtpReceiveStream::clock_rate() {
+    QCOMPARE(RtpReceiveStream::clock_rate(0), uint32_t(8000));
+    QCOMPARE(RtpReceiveStream::clock_rate(8), uint32_t(8000));
+    QCOMPARE(RtpReceiveStream::clock_rate(9), uint32_t(8000));
+    QCOMPARE(RtpReceiveStream::clock_rate(101), uint32_t(8000));
+    QCOMPARE(RtpReceiveStream::clock_rate(11), uint32_t(44100));
+    QCOMPARE(RtpReceiveStream::clock_rate(26), uint32_t(90000));
+}
+
+QTEST_APPLESS_MAIN(TestRtpReceiveStream)
+
+#include "tst_rtpreceivestream.moc"
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file tst_sipclassifier.cpp:
+ *Unit test of the SipClassifier-Class with PJSIP-logentries: direction,
+ *request/response, transport and peer out of the log-line, the method of a
+ *request and of a response (CSeq) and the spans of Call-ID, CSeq, top Via
+ *and body.
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipclassifier.h"
+
+#include <QtTest>
+
+#include <cstring>
+
+class TestSipClassifier : public QObject {
+    Q_OBJECT
+
+private slots:
+    void tx_request();
+    void rx_response();
+    void compact_headers_ipv6();
+    void no_sip_message();
+    void parse_method();
+
+private:
+    static QByteArray span(const char* entry, size_t message_offset, const SipSpan& span);
+};
+
+QByteArray TestSipClassifier::span(const char* entry, size_t message_offset, const SipSpan& span) {
+    return QByteArray(entry + message_offset + span.offset, span.length);
+}
+
+void TestSipClassifier::tx_request() {
+    const char* entry =
+        "10:00:00.000 pjsua_core.c  .TX 512 bytes Request msg INVITE/cseq=1 (tdta0x1) to TCP 10.0.0.2:5060:\n"
+        "INVITE sip:bob@example.com SIP/2.0\r\n"
+        "Via: SIP/2.0/TCP 10.0.0.1:5060;rport;branch=z9hG4bK1\r\n"
+        "Via: SIP/2.0/TCP 10.0.0.9:5060;branch=z9hG4bK0\r\n"
+        "Call-ID: abc@10.0.0.1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Content-Length: 4\r\n"
+        "\r\n"
+        "v=0\n"
+        "\n--end msg--";
+    SipMessageInfo info;
+    size_t offset = 0;
+    size_t size = 0;
+    QVERIFY(SipClassifier::classify(entry, strlen(entry), info, offset, size));
+
+    QCOMPARE(info.direction, SipMessageInfo::Tx);
+    QVERIFY(info.is_request);
+    QCOMPARE(info.method, SipMessageInfo::Invite);
+    QCOMPARE(info.status_code, quint16(0));
+    QCOMPARE(info.transport, SipMessageInfo::Tcp);
+    QCOMPARE(QByteArray(info.remote_ip), QByteArray("10.0.0.2"));
+    QCOMPARE(info.remote_port, quint16(5060));
+
+    QVERIFY(QByteArray(entry + offset, int(size)).startsWith("INVITE sip:bob@example.com"));
+    QVERIFY(QByteArray(entry + offset, int(size)).endsWith("v=0\n"));
+    QCOMPARE(TestSipClassifier::span(entry, offset, info.call_id), QByteArray("abc@10.0.0.1"));
+    QCOMPARE(TestSipClassifier::span(entry, offset, info.cseq), QByteArray("1 INVITE"));
+    QCOMPARE(TestSipClassifier::span(entry, offset, info.via_host), QByteArray("10.0.0.1"));
+    QCOMPARE(TestSipClassifier::span(entry, offset, info.body), QByteArray("v=0\n"));
+}
+
+void TestSipClassifier::rx_response() {
+    const char* entry =
+        "10:00:00.100 pjsua_core.c  .RX 300 bytes Response msg 180/INVITE/cseq=1 (rdata0x2) from UDP 10.0.0.2:5060:\n"
+        "SIP/2.0 180 Ringing\r\n"
+        "Via: SIP/2.0/UDP 10.0.0.1:5060;branch=z9hG4bK1\r\n"
+        "Call-ID: abc@10.0.0.1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n"
+        "--end msg--";
+    SipMessageInfo info;
+    size_t offset = 0;
+    size_t size = 0;
+    QVERIFY(SipClassifier::classify(entry, strlen(entry), info, offset, size));
+
+    QCOMPARE(info.direction, SipMessageInfo::Rx);
+    QVERIFY(!info.is_request);
+    QCOMPARE(info.status_code, quint16(180));
+    //The method of a response comes out of CSeq
+    QCOMPARE(info.method, SipMessageInfo::Invite);
+    QCOMPARE(info.transport, SipMessageInfo::Udp);
+    QCOMPARE(QByteArray(info.remote_ip), QByteArray("10.0.0.2"));
+    QVERIFY(info.body.is_empty());
+}
+
+void TestSipClassifier::compact_headers_ipv6() {
+    const char* entry =
+        "10:00:00.200 pjsua_core.c  .TX 200 bytes Request msg BYE/cseq=2 (tdta0x3) to TLS [2001:db8::2]:5061:\n"
+        "BYE sip:bob@example.com SIP/2.0\r\n"
+        "v: SIP/2.0/TLS [2001:db8::1]:5061;branch=z9hG4bK2\r\n"
+        "i: xyz\r\n"
+        "CSeq: 2 BYE\r\n"
+        "\r\n"
+        "--end msg--";
+    SipMessageInfo info;
+    size_t offset = 0;
+    size_t size = 0;
+    QVERIFY(SipClassifier::classify(entry, strlen(entry), info, offset, size));
+
+    QCOMPARE(info.method, SipMessageInfo::Bye);
+    QCOMPARE(info.transport, SipMessageInfo::Tls);
+    QCOMPARE(QByteArray(info.remote_ip), QByteArray("2001:db8::2"));
+    QCOMPARE(info.remote_port, quint16(5061));
+    QCOMPARE(TestSipClassifier::span(entry, offset, info.call_id), QByteArray("xyz"));
+    QCOMPARE(TestSipClassifier::span(entry, offset, info.via_host), QByteArray("2001:db8::1"));
+}
+
+void TestSipClassifier::no_sip_message() {
+    SipMessageInfo info;
+    size_t offset = 0;
+    size_t size = 0;
+    const char* status = "10:00:00.300 pjsua_acc.c  .Registration sent\n";
+    QVERIFY(!SipClassifier::classify(status, strlen(status), info, offset, size));
+    const char* no_line = "RX 12 bytes Request msg";
+    QVERIFY(!SipClassifier::classify(no_line, strlen(no_line), info, offset, size));
+    //"TX" inside a word is no direction
+    const char* word = "10:00:00.400 sip_endpoint.c  MTX 1 bytes Request msg\n";
+    QVERIFY(!SipClassifier::classify(word, strlen(word), info, offset, size));
+}
+
+void TestSipClassifier::parse_method() {
+    QCOMPARE(SipClassifier::parse_method("REGISTER", 8), SipMessageInfo::Register);
+    QCOMPARE(SipClassifier::parse_method("PUBLISH", 7), SipMessageInfo::Publish);
+    QCOMPARE(SipClassifier::parse_method("INVITEX", 7), SipMessageInfo::UnknownMethod);
+    QCOMPARE(SipClassifier::parse_method("invite", 6), SipMessageInfo::UnknownMethod);
+    QCOMPARE(QByteArray(SipMessageInfo::method_name(SipMessageInfo::Prack)), QByteArray("PRACK"));
+}
+
+QTEST_APPLESS_MAIN(TestSipClassifier)
+
+#include "tst_sipclassifier.moc"
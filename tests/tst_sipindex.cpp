@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2025-2025 Dennis Kühnlein <d.kuehnlein@outlook.com>
+ *
+ * *********************RTP-Generator******************************
+ *
+ *The purpose of the RTP-Generator is to establish a working call
+ *and send a customized RTP-stream. This can be used to test the
+ *behavior of IMS network-elements in edge-cases and to force
+ *the user-agent behavior out of the world.
+ *Due to the dynamic routing inside an IMS there are also some config-
+ *options for the call-setup like:
+ *- activating/deactivating UPDATE
+ *- activating/deactivating 100rel and timer
+ *- configure available codecs (speach and dtmf out-of-band)
+ *
+ *For RTP are more options available such as:
+ *- change SSRC and/or sequence-number after time or packets
+ *- pause rtp-stream for time or complete
+ *- etc. (see mainwindow-ui or README for complete config-option)
+ *
+ *
+ *
+ *Purpose of the file tst_sipindex.cpp:
+ *Unit test of the SipIndex-Class: rows of a dialog stay in append order,
+ *messages without Call-ID are not indexed, an unknown Call-ID gives no
+ *rows and the key of the index does not point into the message.
+ *
+ *
+ *
+ * License:
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+
+#include "sipindex.h"
+
+#include <QtTest>
+
+#include <cstring>
+
+class TestSipIndex : public QObject {
+    Q_OBJECT
+
+private slots:
+    void rows_per_dialog();
+    void message_without_call_id();
+    void key_is_copied();
+
+private:
+    static SipEvent event(const char* message);
+};
+
+SipEvent TestSipIndex::event(const char* message) {
+    //Wrapped into a PJSIP-logentry, the event only keeps the message like the FlowChart does
+    QByteArray entry("10:00:00.000 pjsua_core.c  .TX 100 bytes Request msg (tdta0x1) to UDP 10.0.0.2:5060:\n");
+    entry.append(message);
+    entry.append("\n--end msg--");
+
+    SipEvent event;
+    size_t offset = 0;
+    size_t size = 0;
+    if (SipClassifier::classify(entry.constData(), size_t(entry.size()), event.info, offset, size)) {
+        event.raw = QByteArray(entry.constData() + offset, int(size));
+    }
+    return event;
+}
+
+void TestSipIndex::rows_per_dialog() {
+    SipIndex index;
+    index.add(0, TestSipIndex::event("INVITE sip:bob@example.com SIP/2.0\r\nCall-ID: a@host\r\nCSeq: 1 INVITE\r\n\r\n"));
+    index.add(1, TestSipIndex::event("OPTIONS sip:bob@example.com SIP/2.0\r\nCall-ID: b@host\r\nCSeq: 1 OPTIONS\r\n\r\n"));
+    index.add(2, TestSipIndex::event("ACK sip:bob@example.com SIP/2.0\r\nCall-ID: a@host\r\nCSeq: 1 ACK\r\n\r\n"));
+    index.add(3, TestSipIndex::event("BYE sip:bob@example.com SIP/2.0\r\ni: a@host\r\nCSeq: 2 BYE\r\n\r\n"));
+
+    QCOMPARE(index.dialog_count(), 2);
+    QCOMPARE(index.rows_for_call_id("a@host"), SipIndex::Rows({0, 2, 3}));
+    QCOMPARE(index.rows_for_call_id("b@host"), SipIndex::Rows({1}));
+    QVERIFY(index.rows_for_call_id("c@host").empty());
+}
+
+void TestSipIndex::message_without_call_id() {
+    SipIndex index;
+    index.add(0, TestSipIndex::event("OPTIONS sip:bob@example.com SIP/2.0\r\nCSeq: 1 OPTIONS\r\n\r\n"));
+    QCOMPARE(index.dialog_count(), 0);
+    QVERIFY(index.rows_for_call_id(QByteArray()).empty());
+}
+
+void TestSipIndex::key_is_copied() {
+    SipIndex index;
+    {
+        SipEvent first = TestSipIndex::event("INVITE sip:bob@example.com SIP/2.0\r\nCall-ID: a@host\r\n\r\n");
+        index.add(0, first);
+        //The message is overwritten in place, a key pointing into it would change with it
+        first.raw.detach();
+        memset(first.raw.data(), 'x', size_t(first.raw.size()));
+    }
+    QCOMPARE(index.rows_for_call_id("a@host"), SipIndex::Rows({0}));
+}
+
+QTEST_APPLESS_MAIN(TestSipIndex)
+
+#include "tst_sipindex.moc"